@@ -0,0 +1,224 @@
+#include "../PluginProcessor.h"
+#include "../Benchmark/SyntheticVoice.h"
+#include "RealtimeAudit.h"
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Drives PlosiveRemoverProcessor through the situations hosts put it in, with
+// every allocation, lock and blocking system call inside processBlock
+// reported by the audit hooks. Parameters are changed between blocks, as a
+// host's automation would; only processBlock itself is audited.
+namespace
+{
+    constexpr double DEFAULT_SAMPLE_RATE = 48000.0;
+    constexpr int DEFAULT_BLOCK_SIZE = 512;
+
+    juce::AudioProcessor::BusesLayout makeLayout(int numChannels)
+    {
+        auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+        return layout;
+    }
+
+    void prepare(PlosiveRemoverProcessor& processor, double sampleRate, int blockSize)
+    {
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+
+    // Renders numBlocks blocks of the test signal, calling beforeBlock (if
+    // given) with the block index ahead of each processBlock
+    void render(PlosiveRemoverProcessor& processor, double sampleRate, int blockSize, int numChannels,
+                int numBlocks, const std::function<void(int)>& beforeBlock = {})
+    {
+        juce::AudioBuffer<float> source(numChannels, blockSize * numBlocks);
+        SyntheticVoice::generate(source, sampleRate, 1, 6.0);
+
+        juce::AudioBuffer<float> block(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            if (beforeBlock)
+                beforeBlock(b);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                block.copyFrom(channel, 0, source, channel, b * blockSize, blockSize);
+
+            processor.processBlock(block, midi);
+        }
+    }
+
+    //==============================================================================
+    void automateParameters(PlosiveRemoverProcessor& processor)
+    {
+        processor.setBusesLayout(makeLayout(2));
+        prepare(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE);
+
+        render(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE, 2, 400, [&](int b)
+        {
+            *processor.threshold = static_cast<float>(b % 25);
+            *processor.reduction = static_cast<float>((b * 7) % 101);
+            *processor.frequency = 100.0f + static_cast<float>((b * 37) % 301);
+            *processor.lookahead = 1.0f + static_cast<float>(b % 20);
+            *processor.splitBand = (b / 10) % 2 == 1;
+            *processor.spectral = (b / 15) % 2 == 1;
+            *processor.repair = (b / 40) % 2 == 1;
+            *processor.repairFftSize = (b / 20) % 4;
+            *processor.link = (b / 30) % PlosiveRemoverProcessor::numLinkModes;
+            processor.setDetectorMode((b / 50) % 2 == 1 ? PlosiveRemoverProcessor::DetectorMode::linearDomain
+                                                        : PlosiveRemoverProcessor::DetectorMode::logDomain);
+        });
+    }
+
+    void changeSampleRates(PlosiveRemoverProcessor& processor)
+    {
+        processor.setBusesLayout(makeLayout(2));
+        *processor.repair = true;
+
+        for (auto sampleRate : { 44100.0, 96000.0, 192000.0, 48000.0 })
+        {
+            processor.releaseResources();
+            prepare(processor, sampleRate, DEFAULT_BLOCK_SIZE);
+            render(processor, sampleRate, DEFAULT_BLOCK_SIZE, 2, 100);
+        }
+    }
+
+    void processWhileUnprepared(PlosiveRemoverProcessor& processor)
+    {
+        processor.setBusesLayout(makeLayout(2));
+
+        // Before the first prepareToPlay, then after releaseResources, with
+        // settings changing in between
+        render(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE, 2, 20);
+
+        prepare(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE);
+        render(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE, 2, 20);
+        processor.releaseResources();
+
+        render(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE, 2, 20, [&](int b)
+        {
+            *processor.lookahead = 2.0f + static_cast<float>(b);
+            *processor.repair = b % 2 == 0;
+        });
+    }
+
+    void changeLayouts(PlosiveRemoverProcessor& processor)
+    {
+        // Both link modes that pair channels, since a shrinking buffer can
+        // split a pair
+        for (auto linkMode : { PlosiveRemoverProcessor::pairs, PlosiveRemoverProcessor::midSide })
+        {
+            // Re-prepared for each layout, as hosts should
+            for (auto numChannels : { 1, 2, 6, 8, 2 })
+            {
+                processor.setBusesLayout(makeLayout(numChannels));
+                prepare(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE);
+                *processor.link = linkMode;
+                render(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE, numChannels, 50);
+            }
+
+            // Layout changed without a new prepareToPlay, and buffers that don't
+            // match the layout, as some hosts do
+            processor.setBusesLayout(makeLayout(8));
+            render(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE, 8, 50);
+            render(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE, 1, 50);
+        }
+    }
+
+    void changeBlockSizes(PlosiveRemoverProcessor& processor)
+    {
+        processor.setBusesLayout(makeLayout(2));
+        prepare(processor, DEFAULT_SAMPLE_RATE, 256);
+        *processor.spectral = true;
+
+        // Smaller than prepared, odd-sized, empty and several times larger
+        for (auto blockSize : { 1, 17, 256, 0, 1000, 4096 })
+            render(processor, DEFAULT_SAMPLE_RATE, blockSize, 2, 40);
+    }
+
+    void restoreStateConcurrently(PlosiveRemoverProcessor& processor)
+    {
+        processor.setBusesLayout(makeLayout(2));
+        prepare(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE);
+
+        juce::MemoryBlock defaults;
+        processor.getStateInformation(defaults);
+
+        *processor.repair = true;
+        *processor.link = PlosiveRemoverProcessor::perChannel;
+        juce::MemoryBlock altered;
+        processor.getStateInformation(altered);
+
+        // A second thread saves and restores state the whole time the audio
+        // thread is running, as a host's session save or preset browser would
+        std::atomic<bool> running { true };
+        std::thread stateThread([&]
+        {
+            for (int i = 0; running; ++i)
+            {
+                auto& state = i % 2 == 0 ? defaults : altered;
+                processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+                juce::MemoryBlock saved;
+                processor.getStateInformation(saved);
+            }
+        });
+
+        render(processor, DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE, 2, 2000);
+
+        running = false;
+        stateThread.join();
+    }
+
+    struct Scenario
+    {
+        const char* name;
+        void (*run)(PlosiveRemoverProcessor&);
+    };
+
+    const Scenario scenarios[] = {
+        { "parameter automation", automateParameters },
+        { "sample rate changes", changeSampleRates },
+        { "processing while unprepared", processWhileUnprepared },
+        { "bus layout changes", changeLayouts },
+        { "block size changes", changeBlockSizes },
+        { "concurrent state restore", restoreStateConcurrently },
+    };
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    long total = 0;
+
+    for (const auto& scenario : scenarios)
+    {
+        RealtimeAudit::resetViolationCount();
+
+        {
+            PlosiveRemoverProcessor processor;
+            scenario.run(processor);
+        }
+
+        auto violations = RealtimeAudit::getViolationCount();
+        total += violations;
+
+        std::cout << juce::String(scenario.name).paddedRight(' ', 32)
+                  << (violations == 0 ? juce::String("ok") : juce::String(violations) + " violation(s)") << std::endl;
+    }
+
+    if (total > 0)
+    {
+        std::cout << "FAIL: " << total << " realtime-safety violation(s) in processBlock" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
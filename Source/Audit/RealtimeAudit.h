@@ -0,0 +1,37 @@
+#pragma once
+
+// Realtime-safety audit. In builds with PLOSIVE_RT_AUDIT set (the
+// PlosiveRtAudit tool), code that runs on the audio thread opens a
+// PLOSIVE_RT_AUDIT_SCOPE, and the hooks in RealtimeAuditHooks.cpp report every
+// allocation, lock and blocking system call made while a scope is open, with
+// a stack trace. In every other build the macro compiles to nothing.
+#if PLOSIVE_RT_AUDIT
+
+namespace RealtimeAudit
+{
+    // Scopes open on this thread; constant-initialised, so reading it from
+    // inside malloc never allocates
+    inline thread_local int audioThreadDepth = 0;
+
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() { ++audioThreadDepth; }
+        ~ScopedAudioThread() { --audioThreadDepth; }
+
+        ScopedAudioThread(const ScopedAudioThread&) = delete;
+        ScopedAudioThread& operator=(const ScopedAudioThread&) = delete;
+    };
+
+    // Violations since start-up or the last reset. Only the first few are
+    // printed with a stack; the rest are counted.
+    long getViolationCount();
+    void resetViolationCount();
+}
+
+#define PLOSIVE_RT_AUDIT_SCOPE RealtimeAudit::ScopedAudioThread realtimeAuditScope
+
+#else
+
+#define PLOSIVE_RT_AUDIT_SCOPE do {} while (false)
+
+#endif
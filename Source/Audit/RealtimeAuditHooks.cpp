@@ -0,0 +1,286 @@
+#include "RealtimeAudit.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Interposes the allocator, locks and blocking system calls for the audit
+// build. Each hook reports when the calling thread is inside a
+// PLOSIVE_RT_AUDIT_SCOPE, then forwards to the real function.
+//
+// On Linux with glibc the C allocator itself is replaced (so malloc from C
+// code and from JUCE is caught, not just operator new), and the lock and
+// system call wrappers are found with dlsym(RTLD_NEXT). Elsewhere only
+// operator new and delete are replaced.
+
+#if defined(__linux__) && defined(__GLIBC__)
+ #define PLOSIVE_RT_AUDIT_FULL_HOOKS 1
+ #include <dlfcn.h>
+ #include <errno.h>
+ #include <execinfo.h>
+ #include <fcntl.h>
+ #include <poll.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <stdarg.h>
+ #include <sys/select.h>
+ #include <time.h>
+ #include <unistd.h>
+#else
+ #define PLOSIVE_RT_AUDIT_FULL_HOOKS 0
+ #include <cstdio>
+#endif
+
+namespace
+{
+    constexpr long MAX_REPORTED_STACKS = 10;
+    constexpr int MAX_STACK_DEPTH = 32;
+
+    std::atomic<long> violations{0};
+    thread_local bool reporting = false;   // the report itself writes and may lock
+
+    void writeError(const char* text);
+    void writeStack();
+
+    void report(const char* function)
+    {
+        if (RealtimeAudit::audioThreadDepth == 0 || reporting)
+            return;
+
+        reporting = true;
+        auto count = violations.fetch_add(1, std::memory_order_relaxed) + 1;
+
+        if (count <= MAX_REPORTED_STACKS)
+        {
+            writeError("[rt-audit] ");
+            writeError(function);
+            writeError(" called on the audio thread\n");
+            writeStack();
+        }
+        else if (count == MAX_REPORTED_STACKS + 1)
+        {
+            writeError("[rt-audit] further violations are counted without stacks\n");
+        }
+
+        reporting = false;
+    }
+}
+
+long RealtimeAudit::getViolationCount()
+{
+    return violations.load();
+}
+
+void RealtimeAudit::resetViolationCount()
+{
+    violations.store(0);
+}
+
+#if PLOSIVE_RT_AUDIT_FULL_HOOKS
+
+//==============================================================================
+// glibc's allocator entry points stay reachable under these names, so the
+// replacements below never need dlsym (which can itself allocate)
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+}
+
+namespace
+{
+    template <typename Function>
+    Function findNext(std::atomic<Function>& cache, const char* name)
+    {
+        auto function = cache.load(std::memory_order_acquire);
+
+        if (function == nullptr)
+        {
+            function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+            cache.store(function, std::memory_order_release);
+        }
+
+        return function;
+    }
+
+    using WriteFunction = ssize_t (*)(int, const void*, size_t);
+    std::atomic<WriteFunction> realWrite{nullptr};
+
+    void writeError(const char* text)
+    {
+        findNext(realWrite, "write")(STDERR_FILENO, text, std::strlen(text));
+    }
+
+    void writeStack()
+    {
+        void* frames[MAX_STACK_DEPTH];
+        auto depth = backtrace(frames, MAX_STACK_DEPTH);
+
+        // Skip report() and the hook
+        if (depth > 2)
+            backtrace_symbols_fd(frames + 2, depth - 2, STDERR_FILENO);
+
+        writeError("\n");
+    }
+
+    // backtrace() loads libgcc on first use, which allocates; do that up front.
+    // Resolving the forwarders here keeps dlsym off the audio thread as well.
+    __attribute__((constructor)) void prepareHooks()
+    {
+        void* frames[1];
+        backtrace(frames, 1);
+        findNext(realWrite, "write");
+    }
+}
+
+#define PLOSIVE_RT_AUDIT_FORWARD(name, returnType, parameters, arguments)          \
+    extern "C" returnType name parameters                                          \
+    {                                                                              \
+        using Function = returnType (*) parameters;                                \
+        static std::atomic<Function> real{nullptr};                                \
+        report(#name);                                                             \
+        return findNext(real, #name) arguments;                                    \
+    }
+
+//==============================================================================
+extern "C" void* malloc(size_t size)
+{
+    report("malloc");
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+    report("calloc");
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* p, size_t size)
+{
+    report("realloc");
+    return __libc_realloc(p, size);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size)
+{
+    report("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size)
+{
+    report("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** result, size_t alignment, size_t size)
+{
+    report("posix_memalign");
+
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    auto* p = __libc_memalign(alignment, size);
+    if (p == nullptr)
+        return ENOMEM;
+
+    *result = p;
+    return 0;
+}
+
+extern "C" void free(void* p)
+{
+    if (p != nullptr)
+        report("free");
+
+    __libc_free(p);
+}
+
+//==============================================================================
+// Locks. std::mutex, juce::CriticalSection and juce::SpinLock's fallback all
+// end up in one of these. The function-scope caches are plain atomics rather
+// than guarded statics, since guard acquisition may itself take a lock.
+PLOSIVE_RT_AUDIT_FORWARD(pthread_mutex_lock, int, (pthread_mutex_t* mutex), (mutex))
+PLOSIVE_RT_AUDIT_FORWARD(pthread_rwlock_rdlock, int, (pthread_rwlock_t* lock), (lock))
+PLOSIVE_RT_AUDIT_FORWARD(pthread_rwlock_wrlock, int, (pthread_rwlock_t* lock), (lock))
+PLOSIVE_RT_AUDIT_FORWARD(sem_wait, int, (sem_t* semaphore), (semaphore))
+
+// Blocking system calls
+PLOSIVE_RT_AUDIT_FORWARD(read, ssize_t, (int fd, void* data, size_t size), (fd, data, size))
+PLOSIVE_RT_AUDIT_FORWARD(write, ssize_t, (int fd, const void* data, size_t size), (fd, data, size))
+PLOSIVE_RT_AUDIT_FORWARD(close, int, (int fd), (fd))
+PLOSIVE_RT_AUDIT_FORWARD(fsync, int, (int fd), (fd))
+PLOSIVE_RT_AUDIT_FORWARD(nanosleep, int, (const struct timespec* duration, struct timespec* remaining),
+                         (duration, remaining))
+PLOSIVE_RT_AUDIT_FORWARD(clock_nanosleep, int, (clockid_t clock, int flags, const struct timespec* duration,
+                                                struct timespec* remaining),
+                         (clock, flags, duration, remaining))
+PLOSIVE_RT_AUDIT_FORWARD(usleep, int, (useconds_t microseconds), (microseconds))
+PLOSIVE_RT_AUDIT_FORWARD(poll, int, (struct pollfd* fds, nfds_t count, int timeout), (fds, count, timeout))
+PLOSIVE_RT_AUDIT_FORWARD(select, int, (int count, fd_set* readSet, fd_set* writeSet, fd_set* errorSet,
+                                       struct timeval* timeout),
+                         (count, readSet, writeSet, errorSet, timeout))
+
+// open() is variadic; the mode is only passed when creating
+extern "C" int open(const char* path, int flags, ...)
+{
+    using Function = int (*)(const char*, int, ...);
+    static std::atomic<Function> real{nullptr};
+    report("open");
+
+    mode_t mode = 0;
+    if ((flags & O_CREAT) != 0)
+    {
+        va_list args;
+        va_start(args, flags);
+        mode = static_cast<mode_t>(va_arg(args, int));
+        va_end(args);
+    }
+
+    return findNext(real, "open")(path, flags, mode);
+}
+
+#else
+
+//==============================================================================
+namespace
+{
+    void writeError(const char* text)
+    {
+        std::fputs(text, stderr);
+    }
+
+    void writeStack()
+    {
+    }
+
+    void* auditedAlloc(std::size_t size)
+    {
+        report("operator new");
+
+        if (auto* p = std::malloc(size == 0 ? 1 : size))
+            return p;
+
+        throw std::bad_alloc();
+    }
+
+    void auditedFree(void* p)
+    {
+        if (p != nullptr)
+            report("operator delete");
+
+        std::free(p);
+    }
+}
+
+void* operator new(std::size_t size) { return auditedAlloc(size); }
+void* operator new[](std::size_t size) { return auditedAlloc(size); }
+void operator delete(void* p) noexcept { auditedFree(p); }
+void operator delete[](void* p) noexcept { auditedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { auditedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { auditedFree(p); }
+
+#endif
@@ -0,0 +1,245 @@
+#include "BatchRenderer.h"
+#include <iostream>
+
+namespace
+{
+    struct BatchJob
+    {
+        juce::File input;
+        juce::File output;
+        BatchResult result;
+    };
+
+    // Shared work list: workers claim the next unrendered file until none are left
+    struct JobQueue
+    {
+        std::vector<BatchJob> jobs;
+        std::atomic<size_t> nextJob{0};
+        juce::CriticalSection printLock;
+    };
+
+    class BatchWorker : public juce::Thread
+    {
+    public:
+        BatchWorker(JobQueue& q, const BatchOptions& options, int index)
+            : juce::Thread("Plosive batch worker " + juce::String(index)),
+              queue(q), renderer(options), compare(options.compareDetectors),
+              withEvents(options.eventFormat.isNotEmpty())
+        {
+        }
+
+        void run() override
+        {
+            for (;;)
+            {
+                auto index = queue.nextJob.fetch_add(1);
+                if (index >= queue.jobs.size() || threadShouldExit())
+                    return;
+
+                auto& job = queue.jobs[index];
+                job.result = compare ? renderer.compareDetectors(job.input)
+                                     : renderer.render(job.input, job.output);
+
+                const juce::ScopedLock sl(queue.printLock);
+                if (job.result.ok && compare)
+                    std::cout << "ok    " << job.input.getFullPathName()
+                              << " (max " << juce::String(job.result.maxGainDeviationDb, 4) << " dB)" << std::endl;
+                else if (job.result.ok && withEvents)
+                    std::cout << "ok    " << job.input.getFullPathName()
+                              << " (" << job.result.numEvents << " plosives)" << std::endl;
+                else if (job.result.ok)
+                    std::cout << "ok    " << job.input.getFullPathName() << std::endl;
+                else
+                    std::cout << "FAIL  " << job.input.getFullPathName() << " (" << job.result.error << ")" << std::endl;
+            }
+        }
+
+    private:
+        JobQueue& queue;
+        BatchRenderer renderer;
+        const bool compare;
+        const bool withEvents;
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: PlosiveBatch -o <output dir> [options] <files or directories...>\n"
+                     "\n"
+                     "Options:\n"
+                     "  -o, --output <dir>       Where rendered files are written\n"
+                     "  -j, --threads <n>        Worker threads (default: all cores)\n"
+                     "  -b, --block-size <n>     Samples per processBlock call (default: 8192)\n"
+                     "  --sensitivity <dB>       0-24 (default: 6)\n"
+                     "  --reduction <%>          0-100 (default: 70)\n"
+                     "  --frequency <Hz>         100-400 (default: 200)\n"
+                     "  --lookahead <ms>         1-20 (default: 5)\n"
+                     "  --detector <log|linear>  Detector implementation (default: log)\n"
+                     "  --link <mode>            linked, channel, pairs or midside (default: linked)\n"
+                     "  --repair <size>          Spectral repair with a 256, 512, 1024 or 2048\n"
+                     "                           point FFT instead of broadband reduction\n"
+                     "  --events <json|csv>      Also write <name>.events.json/.csv listing each\n"
+                     "                           plosive's onset, length, peak excess and\n"
+                     "                           minimum gain\n"
+                     "  --two-pass               Analyse each file's low-band level first and\n"
+                     "                           take the auto-threshold from the whole file\n"
+                     "                           instead of a running average\n"
+                     "  --compare-detectors      Don't render; fail any file where the linear\n"
+                     "                           detector's gain curve differs from the log\n"
+                     "                           detector's by more than 0.01 dB\n"
+                     "\n"
+                     "Directories are searched recursively for .wav and .flac files and\n"
+                     "their layout is mirrored under the output directory." << std::endl;
+    }
+
+    bool isRepairFftSize(int size)
+    {
+        return size >= (1 << SpectralRepair::MIN_ORDER) && size <= SpectralRepair::MAX_FFT_SIZE
+            && juce::isPowerOfTwo(size);
+    }
+
+    juce::File resolvePath(const juce::String& path)
+    {
+        return juce::File::getCurrentWorkingDirectory().getChildFile(path);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    BatchOptions options;
+    juce::File outputDir;
+    juce::StringArray inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(argv[i]);
+        bool hasValue = (i + 1 < argc);
+
+        if ((arg == "-o" || arg == "--output") && hasValue)
+            outputDir = resolvePath(argv[++i]);
+        else if ((arg == "-j" || arg == "--threads") && hasValue)
+            options.numThreads = juce::String(argv[++i]).getIntValue();
+        else if ((arg == "-b" || arg == "--block-size") && hasValue)
+            options.blockSize = juce::jmax(16, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--sensitivity" && hasValue)
+            options.sensitivity = juce::jlimit(0.0f, 24.0f, juce::String(argv[++i]).getFloatValue());
+        else if (arg == "--reduction" && hasValue)
+            options.reduction = juce::jlimit(0.0f, 100.0f, juce::String(argv[++i]).getFloatValue());
+        else if (arg == "--frequency" && hasValue)
+            options.frequency = juce::jlimit(100.0f, 400.0f, juce::String(argv[++i]).getFloatValue());
+        else if (arg == "--lookahead" && hasValue)
+            options.lookaheadMs = juce::jlimit(PlosiveRemoverProcessor::MIN_LOOKAHEAD_MS,
+                                               PlosiveRemoverProcessor::MAX_LOOKAHEAD_MS,
+                                               juce::String(argv[++i]).getFloatValue());
+        else if (arg == "--detector" && hasValue)
+            options.detectorMode = juce::String(argv[++i]) == "linear"
+                                     ? PlosiveRemoverProcessor::DetectorMode::linearDomain
+                                     : PlosiveRemoverProcessor::DetectorMode::logDomain;
+        else if (arg == "--link" && hasValue)
+        {
+            juce::String mode(argv[++i]);
+            options.linkMode = mode == "channel" ? PlosiveRemoverProcessor::perChannel
+                             : mode == "pairs"   ? PlosiveRemoverProcessor::pairs
+                             : mode == "midside" ? PlosiveRemoverProcessor::midSide
+                                                 : PlosiveRemoverProcessor::linked;
+        }
+        else if (arg == "--repair" && hasValue && isRepairFftSize(juce::String(argv[i + 1]).getIntValue()))
+            options.repairFftSize = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--events" && hasValue)
+            options.eventFormat = juce::String(argv[++i]) == "csv" ? "csv" : "json";
+        else if (arg == "--two-pass")
+            options.twoPass = true;
+        else if (arg == "--compare-detectors")
+            options.compareDetectors = true;
+        else if (arg == "-h" || arg == "--help")
+        {
+            printUsage();
+            return 0;
+        }
+        else if (arg.startsWith("-"))
+        {
+            std::cout << "Unknown or incomplete option: " << arg << "\n\n";
+            printUsage();
+            return 1;
+        }
+        else
+            inputs.add(arg);
+    }
+
+    if ((outputDir == juce::File() && !options.compareDetectors) || inputs.size() == 0)
+    {
+        printUsage();
+        return 1;
+    }
+
+    JobQueue queue;
+
+    for (auto& path : inputs)
+    {
+        auto file = resolvePath(path);
+
+        if (file.isDirectory())
+        {
+            for (auto& child : file.findChildFiles(juce::File::findFiles, true, "*.wav;*.flac"))
+                queue.jobs.push_back({ child, outputDir.getChildFile(child.getRelativePathFrom(file)), {} });
+        }
+        else if (file.existsAsFile())
+        {
+            queue.jobs.push_back({ file, outputDir.getChildFile(file.getFileName()), {} });
+        }
+        else
+        {
+            std::cout << "Skipping missing input: " << file.getFullPathName() << std::endl;
+        }
+    }
+
+    if (queue.jobs.empty())
+    {
+        std::cout << "No input files found" << std::endl;
+        return 1;
+    }
+
+    auto numThreads = options.numThreads > 0 ? options.numThreads : juce::SystemStats::getNumCpus();
+    numThreads = juce::jlimit(1, static_cast<int>(queue.jobs.size()), numThreads);
+
+    // One processor instance per worker; files are handed out dynamically so
+    // long and short files balance across cores
+    std::vector<std::unique_ptr<BatchWorker>> workers;
+    for (int i = 0; i < numThreads; ++i)
+        workers.push_back(std::make_unique<BatchWorker>(queue, options, i));
+
+    auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    for (auto& worker : workers)
+        worker->startThread();
+
+    for (auto& worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    auto elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+    elapsedSeconds = juce::jmax(elapsedSeconds, 1.0e-6);
+
+    int numOk = 0;
+    double audioSeconds = 0.0;
+    for (auto& job : queue.jobs)
+    {
+        if (job.result.ok)
+        {
+            ++numOk;
+            audioSeconds += job.result.audioSeconds;
+        }
+    }
+
+    auto numFailed = static_cast<int>(queue.jobs.size()) - numOk;
+
+    std::cout << "\n"
+              << numOk << " file(s) rendered, " << numFailed << " failed, "
+              << numThreads << " thread(s)\n"
+              << "Elapsed:         " << juce::String(elapsedSeconds, 2) << " s\n"
+              << "Audio processed: " << juce::String(audioSeconds, 1) << " s\n"
+              << "Files/sec:       " << juce::String(numOk / elapsedSeconds, 2) << "\n"
+              << "Realtime factor: " << juce::String(audioSeconds / elapsedSeconds, 1) << "x" << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+#include "BatchRenderer.h"
+#include "EventExport.h"
+#include <cmath>
+
+BatchRenderer::BatchRenderer(const BatchOptions& opts)
+    : options(opts)
+{
+    formatManager.registerBasicFormats();
+    processor.setNonRealtime(true);
+}
+
+bool BatchRenderer::prepareProcessor(PlosiveRemoverProcessor& target, int numChannels, double sampleRate)
+{
+    auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+
+    if (!target.setBusesLayout(layout))
+        return false;
+
+    *target.threshold = options.sensitivity;
+    *target.reduction = options.reduction;
+    *target.frequency = options.frequency;
+    *target.lookahead = options.lookaheadMs;
+    *target.link = options.linkMode;
+    *target.repair = options.repairFftSize > 0;
+    if (options.repairFftSize > 0)
+        *target.repairFftSize = target.repairFftSize->choices.indexOf(juce::String(options.repairFftSize));
+    target.setDetectorMode(options.detectorMode);
+
+    target.setRateAndBufferSizeDetails(sampleRate, options.blockSize);
+    target.prepareToPlay(sampleRate, options.blockSize);
+    return true;
+}
+
+BatchResult BatchRenderer::render(const juce::File& input, const juce::File& output)
+{
+    BatchResult result;
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+    if (reader == nullptr)
+    {
+        result.error = "unsupported or unreadable file";
+        return result;
+    }
+
+    auto numChannels = static_cast<int>(reader->numChannels);
+    auto totalSamples = reader->lengthInSamples;
+
+    if (!prepareProcessor(processor, numChannels, reader->sampleRate))
+    {
+        result.error = "unsupported channel count (" + juce::String(numChannels) + ")";
+        return result;
+    }
+
+    auto* format = formatManager.findFormatForFileExtension(input.getFileExtension());
+    if (format == nullptr)
+    {
+        result.error = "no writer for " + input.getFileExtension();
+        return result;
+    }
+
+    // FLAC tops out at 24 bits, so fall back when the source depth can't be written as-is
+    auto bitsPerSample = static_cast<int>(reader->bitsPerSample);
+    if (!format->getPossibleBitDepths().contains(bitsPerSample))
+        bitsPerSample = 24;
+
+    output.getParentDirectory().createDirectory();
+    output.deleteFile();
+
+    auto stream = output.createOutputStream();
+    if (stream == nullptr)
+    {
+        result.error = "cannot open " + output.getFullPathName();
+        return result;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(
+        stream.get(), reader->sampleRate, static_cast<unsigned int>(numChannels),
+        bitsPerSample, reader->metadataValues, 0));
+
+    if (writer == nullptr)
+    {
+        result.error = "cannot create writer";
+        return result;
+    }
+
+    stream.release(); // now owned by the writer
+
+    buffer.setSize(numChannels, options.blockSize, false, false, true);
+
+    if (options.twoPass)
+        analyseLevels(*reader);
+
+    // Anything still queued belongs to a previous file
+    processor.eventQueue.drain([](const PlosiveEvent&) {});
+    processor.eventQueue.takeDroppedCount();
+    events.clear();
+
+    // The processor delays its output by the look-ahead, so drop that many
+    // leading samples and keep feeding silence until the tail has come out.
+    // The rendered file is then sample-aligned with the source.
+    int samplesToSkip = processor.getLatencySamples();
+    juce::int64 readPos = 0;
+    juce::int64 written = 0;
+
+    while (written < totalSamples)
+    {
+        buffer.clear();
+
+        auto numToRead = static_cast<int>(juce::jmin<juce::int64>(options.blockSize, totalSamples - readPos));
+        if (numToRead > 0)
+        {
+            reader->read(&buffer, 0, numToRead, readPos, true, true);
+            readPos += numToRead;
+        }
+
+        processor.processBlock(buffer, midi);
+        collectEvents();
+
+        auto start = juce::jmin(samplesToSkip, options.blockSize);
+        samplesToSkip -= start;
+
+        auto numToWrite = static_cast<int>(juce::jmin<juce::int64>(options.blockSize - start, totalSamples - written));
+        if (numToWrite > 0)
+        {
+            if (!writer->writeFromAudioSampleBuffer(buffer, start, numToWrite))
+            {
+                result.error = "write failed";
+                return result;
+            }
+
+            written += numToWrite;
+        }
+    }
+
+    processor.flushEvents();
+    collectEvents();
+    processor.setLevelProfile(nullptr);
+    processor.releaseResources();
+
+    if (options.eventFormat.isNotEmpty())
+    {
+        if (processor.eventQueue.takeDroppedCount() > 0)
+        {
+            result.error = "event queue overflowed; try a smaller block size";
+            return result;
+        }
+
+        if (!writeEventIndex(output, reader->sampleRate, input.getFileName()))
+        {
+            result.error = "cannot write event index";
+            return result;
+        }
+
+        result.numEvents = static_cast<int>(events.size());
+    }
+
+    result.ok = true;
+    result.audioSeconds = static_cast<double>(totalSamples) / reader->sampleRate;
+    return result;
+}
+
+void BatchRenderer::analyseLevels(juce::AudioFormatReader& reader)
+{
+    // First pass: the whole file's low-band level, so the render knows every
+    // unit's auto-threshold reference from the first sample
+    processor.beginLevelAnalysis(levelProfile, reader.lengthInSamples);
+
+    for (juce::int64 readPos = 0; readPos < reader.lengthInSamples; readPos += options.blockSize)
+    {
+        auto numToRead = static_cast<int>(juce::jmin<juce::int64>(options.blockSize, reader.lengthInSamples - readPos));
+        reader.read(&buffer, 0, numToRead, readPos, true, true);
+        processor.analyseLevels(buffer, numToRead, levelProfile);
+    }
+
+    levelProfile.finish();
+    processor.setLevelProfile(&levelProfile);
+}
+
+void BatchRenderer::collectEvents()
+{
+    processor.eventQueue.drain([this](const PlosiveEvent& e) { events.push_back(e); });
+}
+
+bool BatchRenderer::writeEventIndex(const juce::File& audioOutput, double sampleRate, const juce::String& sourceName)
+{
+    EventExport::sortByOnset(events);
+
+    auto csv = options.eventFormat == "csv";
+    auto file = audioOutput.getSiblingFile(audioOutput.getFileNameWithoutExtension()
+                                           + (csv ? ".events.csv" : ".events.json"));
+
+    return file.replaceWithText(csv ? EventExport::toCsv(events, sampleRate)
+                                    : EventExport::toJson(events, sampleRate, sourceName));
+}
+
+BatchResult BatchRenderer::compareDetectors(const juce::File& input)
+{
+    BatchResult result;
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+    if (reader == nullptr)
+    {
+        result.error = "unsupported or unreadable file";
+        return result;
+    }
+
+    auto numChannels = static_cast<int>(reader->numChannels);
+    auto totalSamples = reader->lengthInSamples;
+
+    PlosiveRemoverProcessor linear;
+    linear.setNonRealtime(true);
+
+    if (!prepareProcessor(processor, numChannels, reader->sampleRate)
+        || !prepareProcessor(linear, numChannels, reader->sampleRate))
+    {
+        result.error = "unsupported channel count (" + juce::String(numChannels) + ")";
+        return result;
+    }
+
+    processor.setDetectorMode(PlosiveRemoverProcessor::DetectorMode::logDomain);
+    linear.setDetectorMode(PlosiveRemoverProcessor::DetectorMode::linearDomain);
+
+    buffer.setSize(numChannels, options.blockSize, false, false, true);
+    std::vector<float> mono(static_cast<size_t>(options.blockSize));
+    std::vector<float> logGain(mono.size()), linearGain(mono.size());
+
+    for (juce::int64 readPos = 0; readPos < totalSamples; readPos += options.blockSize)
+    {
+        auto numToRead = static_cast<int>(juce::jmin<juce::int64>(options.blockSize, totalSamples - readPos));
+        reader->read(&buffer, 0, numToRead, readPos, true, true);
+
+        // Same mono sum as processBlock
+        juce::FloatVectorOperations::copy(mono.data(), buffer.getReadPointer(0), numToRead);
+        for (int channel = 1; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::add(mono.data(), buffer.getReadPointer(channel), numToRead);
+        if (numChannels > 1)
+            juce::FloatVectorOperations::multiply(mono.data(), 1.0f / static_cast<float>(numChannels), numToRead);
+
+        processor.analyseGainCurve(mono.data(), logGain.data(), numToRead);
+        linear.analyseGainCurve(mono.data(), linearGain.data(), numToRead);
+
+        for (int i = 0; i < numToRead; ++i)
+        {
+            auto deviationDb = std::abs(20.0 * std::log10(static_cast<double>(linearGain[static_cast<size_t>(i)])
+                                                         / static_cast<double>(logGain[static_cast<size_t>(i)])));
+            result.maxGainDeviationDb = juce::jmax(result.maxGainDeviationDb, deviationDb);
+        }
+    }
+
+    processor.releaseResources();
+
+    result.ok = result.maxGainDeviationDb <= options.detectorToleranceDb;
+    if (!result.ok)
+        result.error = "gain curves differ by " + juce::String(result.maxGainDeviationDb, 4) + " dB";
+
+    result.audioSeconds = static_cast<double>(totalSamples) / reader->sampleRate;
+    return result;
+}
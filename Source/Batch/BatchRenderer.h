@@ -0,0 +1,69 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../PluginProcessor.h"
+
+// Settings shared by every worker in a batch run
+struct BatchOptions
+{
+    int blockSize = 8192;
+    int numThreads = 0;     // 0 = one worker per CPU core
+
+    float sensitivity = 6.0f;
+    float reduction = 70.0f;
+    float frequency = 200.0f;
+    float lookaheadMs = 5.0f;
+
+    PlosiveRemoverProcessor::DetectorMode detectorMode = PlosiveRemoverProcessor::DetectorMode::logDomain;
+    int linkMode = PlosiveRemoverProcessor::linked;
+    int repairFftSize = 0;  // spectral repair FFT size (256-2048), or 0 for broadband reduction
+
+    // Analyse each file before rendering it, see LoudnessProfile
+    bool twoPass = false;
+
+    // "json" or "csv" writes a plosive event index next to each rendered file
+    juce::String eventFormat;
+
+    // Instead of rendering, check the linear detector's gain curve against the log one
+    bool compareDetectors = false;
+    double detectorToleranceDb = 0.01;
+};
+
+struct BatchResult
+{
+    bool ok = false;
+    juce::String error;
+    double audioSeconds = 0.0;
+    double maxGainDeviationDb = 0.0;   // compareDetectors only
+    int numEvents = 0;                 // render with an event format only
+};
+
+// Renders whole files through a private PlosiveRemoverProcessor.
+// Not thread-safe: each worker thread owns its own renderer.
+class BatchRenderer
+{
+public:
+    explicit BatchRenderer(const BatchOptions& options);
+
+    BatchResult render(const juce::File& input, const juce::File& output);
+
+    // Runs both detector modes over the file's mono sum and reports the largest
+    // difference between their gain curves
+    BatchResult compareDetectors(const juce::File& input);
+
+private:
+    bool prepareProcessor(PlosiveRemoverProcessor& target, int numChannels, double sampleRate);
+    void collectEvents();
+    bool writeEventIndex(const juce::File& audioOutput, double sampleRate, const juce::String& sourceName);
+    void analyseLevels(juce::AudioFormatReader& reader);
+
+    const BatchOptions& options;
+    juce::AudioFormatManager formatManager;
+    PlosiveRemoverProcessor processor;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+    std::vector<PlosiveEvent> events;
+    LoudnessProfile levelProfile;  // reused from file to file
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchRenderer)
+};
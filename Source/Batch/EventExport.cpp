@@ -0,0 +1,56 @@
+#include "EventExport.h"
+#include <algorithm>
+
+namespace
+{
+    juce::String gainToDbString(float gain)
+    {
+        return juce::String(juce::Decibels::gainToDecibels(gain, -100.0f), 2);
+    }
+}
+
+void EventExport::sortByOnset(std::vector<PlosiveEvent>& events)
+{
+    std::stable_sort(events.begin(), events.end(), [](const PlosiveEvent& a, const PlosiveEvent& b) {
+        return a.onsetSample != b.onsetSample ? a.onsetSample < b.onsetSample : a.unit < b.unit;
+    });
+}
+
+juce::String EventExport::toJson(const std::vector<PlosiveEvent>& events, double sampleRate, const juce::String& sourceName)
+{
+    juce::String json;
+    json << "{\n"
+         << "  \"source\": " << juce::JSON::toString(sourceName) << ",\n"
+         << "  \"sample_rate\": " << juce::String(sampleRate, 0) << ",\n"
+         << "  \"events\": [";
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        auto& e = events[i];
+        json << (i == 0 ? "\n" : ",\n")
+             << "    { \"onset\": " << juce::String(e.onsetSample)
+             << ", \"time\": " << juce::String(static_cast<double>(e.onsetSample) / sampleRate, 4)
+             << ", \"length\": " << e.lengthSamples
+             << ", \"peak_excess_db\": " << juce::String(e.peakExcessDb, 2)
+             << ", \"min_gain_db\": " << gainToDbString(e.minGain)
+             << ", \"unit\": " << e.unit << " }";
+    }
+
+    json << (events.empty() ? "]\n" : "\n  ]\n") << "}\n";
+    return json;
+}
+
+juce::String EventExport::toCsv(const std::vector<PlosiveEvent>& events, double sampleRate)
+{
+    juce::String csv = "onset,time,length,peak_excess_db,min_gain_db,unit\n";
+
+    for (auto& e : events)
+        csv << juce::String(e.onsetSample) << ","
+            << juce::String(static_cast<double>(e.onsetSample) / sampleRate, 4) << ","
+            << e.lengthSamples << ","
+            << juce::String(e.peakExcessDb, 2) << ","
+            << gainToDbString(e.minGain) << ","
+            << e.unit << "\n";
+
+    return csv;
+}
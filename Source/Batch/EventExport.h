@@ -0,0 +1,15 @@
+#pragma once
+
+#include "../PluginProcessor.h"
+
+// Text formats for a render's plosive event index. Output is deterministic
+// (fixed precision, events in order of onset) so indexes from two builds can
+// be diffed directly.
+namespace EventExport
+{
+    juce::String toJson(const std::vector<PlosiveEvent>& events, double sampleRate, const juce::String& sourceName);
+    juce::String toCsv(const std::vector<PlosiveEvent>& events, double sampleRate);
+
+    // Events arrive from the processor as each one closes; this orders them by onset
+    void sortByOnset(std::vector<PlosiveEvent>& events);
+}
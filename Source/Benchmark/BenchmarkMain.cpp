@@ -0,0 +1,1364 @@
+#include "../PluginProcessor.h"
+#include "../Core/PlosiveCore.h"
+#include "../Engine/PlosiveSessionEngine.h"
+#include "SyntheticVoice.h"
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+//==============================================================================
+// Allocation tracking: every operator new made while a processBlock call is in
+// flight on the benchmark thread is counted as an audio-thread allocation.
+// (Over-aligned operator new isn't intercepted.)
+namespace
+{
+    thread_local bool insideProcessBlock = false;
+    std::atomic<long> audioThreadAllocations{0};
+
+    void* countedAlloc(std::size_t size)
+    {
+        if (insideProcessBlock)
+            audioThreadAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        if (auto* p = std::malloc(size == 0 ? 1 : size))
+            return p;
+
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+//==============================================================================
+namespace
+{
+    struct BenchmarkConfig
+    {
+        double seconds = 2.0;       // audio rendered per measurement
+        int repeats = 3;            // best of N
+        bool linearDetector = false;
+        bool splitBand = false;
+        bool spectral = false;
+        int linkMode = PlosiveRemoverProcessor::linked;
+        int repairFftSize = 0;      // spectral repair FFT size, 0 = off
+        int sessionTracks = 0;      // > 0: compare PlosiveSessionEngine against per-track processors
+        bool svfFilter = false;     // SVF detection filter instead of the biquad
+        bool singlePrecision = true;
+        bool doublePrecision = false;
+        bool quick = false;
+        bool regression = false;    // golden-file and block-size regression check instead of the matrix
+        juce::File goldenFile;      // regression results to compare against
+        bool updateGolden = false;  // write goldenFile from this run instead
+        bool automation = false;    // regression: sensitivity, reduction and frequency change mid-render
+        bool twoPass = false;       // regression: offline render against a whole-file level profile
+        bool cache = false;         // gain-envelope cache check instead of the matrix
+        bool compareDetectors = false;  // log against linear detector gains instead of the matrix
+        bool core = false;          // plosive::Processor against the plugin instead of the matrix
+        bool midSideCost = false;   // mid/side against linked processBlock time instead of the matrix
+        int stateInstances = 0;     // > 0: session-load timing of state restores instead of the matrix
+        juce::File csvFile;
+        juce::File profileFile;     // per-stage histograms for every configuration
+    };
+
+    struct Measurement
+    {
+        double nsPerSample = 0.0;   // per sample frame, all channels
+        double realtimeFactor = 0.0;
+        long allocations = 0;
+        juce::String profile;       // DspProfiler::toJson over the timed passes
+    };
+
+    const char* const linkModeNames[] = { "linked", "per channel", "pairs", "mid/side" };
+
+    // Applies the configuration's layout, parameters and precision, then prepares
+    void prepareProcessor(PlosiveRemoverProcessor& processor, const BenchmarkConfig& config, double sampleRate,
+                          int blockSize, int numChannels, bool doublePrecision)
+    {
+        auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+        processor.setBusesLayout(layout);
+
+        *processor.splitBand = config.splitBand;
+        *processor.link = config.linkMode;
+        *processor.spectral = config.spectral;
+        *processor.repair = config.repairFftSize > 0;
+        if (config.repairFftSize > 0)
+            *processor.repairFftSize = processor.repairFftSize->choices.indexOf(juce::String(config.repairFftSize));
+        *processor.detectionFilter = config.svfFilter ? 1 : 0;
+        processor.setDetectorMode(config.linearDetector ? PlosiveRemoverProcessor::DetectorMode::linearDomain
+                                                        : PlosiveRemoverProcessor::DetectorMode::logDomain);
+
+        // The host picks the precision before preparing
+        processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                         : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+
+    template <typename SampleType>
+    Measurement run(const BenchmarkConfig& config, double sampleRate, int blockSize, int numChannels,
+                    const juce::AudioBuffer<float>& source)
+    {
+        constexpr bool isDouble = std::is_same_v<SampleType, double>;
+        PlosiveRemoverProcessor processor;
+        prepareProcessor(processor, config, sampleRate, blockSize, numChannels, isDouble);
+
+        juce::AudioBuffer<SampleType> input;
+        input.makeCopyOf(source);
+
+        const auto totalSamples = source.getNumSamples();
+        juce::AudioBuffer<SampleType> block(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        Measurement best;
+        best.nsPerSample = std::numeric_limits<double>::max();
+
+        // Pass 0 warms caches and settles the envelopes; it isn't timed
+        for (int pass = 0; pass <= config.repeats; ++pass)
+        {
+            juce::int64 ticks = 0;
+            auto allocationsBefore = audioThreadAllocations.load();
+
+            for (int start = 0; start + blockSize <= totalSamples; start += blockSize)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    block.copyFrom(channel, 0, input, channel, start, blockSize);
+
+                auto t0 = juce::Time::getHighResolutionTicks();
+                insideProcessBlock = true;
+                processor.processBlock(block, midi);
+                insideProcessBlock = false;
+                ticks += juce::Time::getHighResolutionTicks() - t0;
+            }
+
+            if (pass == 0)
+            {
+                processor.profiler.reset();
+                continue;
+            }
+
+            auto processed = static_cast<double>((totalSamples / blockSize) * blockSize);
+            auto elapsed = juce::Time::highResolutionTicksToSeconds(ticks);
+
+            Measurement m;
+            m.nsPerSample = elapsed * 1.0e9 / processed;
+            m.realtimeFactor = (processed / sampleRate) / juce::jmax(elapsed, 1.0e-12);
+            m.allocations = audioThreadAllocations.load() - allocationsBefore;
+
+            if (m.nsPerSample < best.nsPerSample)
+                best = m;
+
+            best.allocations = juce::jmax(best.allocations, m.allocations);
+        }
+
+        best.profile = processor.profiler.toJson();
+        processor.releaseResources();
+        return best;
+    }
+
+    // Every track gets different settings and a different slice of the test
+    // signal, so no two lanes of the engine see the same input or parameters
+    void configureSessionTrack(PlosiveRemoverProcessor& processor, int track)
+    {
+        *processor.threshold = 3.0f + static_cast<float>(track % 7) * 3.0f;
+        *processor.reduction = 40.0f + static_cast<float>(track % 5) * 15.0f;
+        *processor.frequency = 120.0f + static_cast<float>(track % 9) * 30.0f;
+        *processor.lookahead = 2.0f + static_cast<float>(track % 4) * 4.0f;
+    }
+
+    int runSession(const BenchmarkConfig& config)
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 256;
+        const int numTracks = config.sessionTracks;
+
+        juce::AudioBuffer<float> source(2, static_cast<int>(sampleRate * config.seconds));
+        SyntheticVoice::generate(source, sampleRate);
+        const auto totalSamples = source.getNumSamples();
+
+        // One processor per track, as a host would run them; every fourth track is mono
+        std::vector<std::unique_ptr<PlosiveRemoverProcessor>> processors;
+        std::vector<int> channelsPerTrack;
+        PlosiveSessionEngine engine;
+
+        for (int t = 0; t < numTracks; ++t)
+        {
+            auto numChannels = t % 4 == 3 ? 1 : 2;
+            channelsPerTrack.push_back(numChannels);
+
+            auto processor = std::make_unique<PlosiveRemoverProcessor>();
+            auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add(channelSet);
+            layout.outputBuses.add(channelSet);
+            processor->setBusesLayout(layout);
+            configureSessionTrack(*processor, t);
+            processor->setDetectorMode(config.linearDetector ? PlosiveRemoverProcessor::DetectorMode::linearDomain
+                                                             : PlosiveRemoverProcessor::DetectorMode::logDomain);
+            processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor->prepareToPlay(sampleRate, blockSize);
+            processors.push_back(std::move(processor));
+        }
+
+        engine.prepare(sampleRate, blockSize, channelsPerTrack.data(), numTracks);
+        engine.setLinearDetector(config.linearDetector);
+
+        int latencyMismatches = 0;
+
+        for (int t = 0; t < numTracks; ++t)
+        {
+            // Read back the (quantised) parameter values so both sides use identical settings
+            auto& processor = *processors[static_cast<size_t>(t)];
+            PlosiveSessionEngine::TrackSettings settings;
+            settings.sensitivityDb = processor.threshold->get();
+            settings.reductionPercent = processor.reduction->get();
+            settings.frequencyHz = processor.frequency->get();
+            settings.lookaheadMs = processor.lookahead->get();
+            engine.setTrackSettings(t, settings);
+
+            if (engine.getLatencySamples(t) != processor.getLatencySamples())
+                ++latencyMismatches;
+        }
+
+        std::vector<juce::AudioBuffer<float>> trackBlocks;
+        for (auto numChannels : channelsPerTrack)
+            trackBlocks.emplace_back(numChannels, blockSize);
+
+        juce::AudioBuffer<float> sessionBlock(engine.getTotalNumChannels(), blockSize);
+        juce::MidiBuffer midi;
+        juce::int64 processorTicks = 0, engineTicks = 0;
+        float maxDifference = 0.0f;
+        long mismatchedSamples = 0;
+        auto allocationsBefore = audioThreadAllocations.load();
+
+        for (int start = 0; start + blockSize <= totalSamples; start += blockSize)
+        {
+            for (int t = 0; t < numTracks; ++t)
+            {
+                auto offset = (start + t * 997) % (totalSamples - blockSize);
+                auto gain = 0.5f + 0.05f * static_cast<float>(t % 10);
+                auto& block = trackBlocks[static_cast<size_t>(t)];
+
+                for (int channel = 0; channel < block.getNumChannels(); ++channel)
+                {
+                    block.copyFrom(channel, 0, source.getReadPointer(channel, offset), blockSize, gain);
+                    sessionBlock.copyFrom(engine.getFirstChannel(t) + channel, 0, block, channel, 0, blockSize);
+                }
+            }
+
+            insideProcessBlock = true;
+            auto t0 = juce::Time::getHighResolutionTicks();
+
+            for (int t = 0; t < numTracks; ++t)
+                processors[static_cast<size_t>(t)]->processBlock(trackBlocks[static_cast<size_t>(t)], midi);
+
+            auto t1 = juce::Time::getHighResolutionTicks();
+            engine.process(sessionBlock.getArrayOfWritePointers(), blockSize);
+            auto t2 = juce::Time::getHighResolutionTicks();
+            insideProcessBlock = false;
+
+            processorTicks += t1 - t0;
+            engineTicks += t2 - t1;
+
+            for (int t = 0; t < numTracks; ++t)
+            {
+                auto& block = trackBlocks[static_cast<size_t>(t)];
+
+                for (int channel = 0; channel < block.getNumChannels(); ++channel)
+                {
+                    const auto* expected = block.getReadPointer(channel);
+                    const auto* actual = sessionBlock.getReadPointer(engine.getFirstChannel(t) + channel);
+
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        if (expected[i] != actual[i])
+                        {
+                            ++mismatchedSamples;
+                            maxDifference = std::max(maxDifference, std::abs(expected[i] - actual[i]));
+                        }
+                    }
+                }
+            }
+        }
+
+        auto allocations = audioThreadAllocations.load() - allocationsBefore;
+        auto frames = static_cast<double>((totalSamples / blockSize) * blockSize) * numTracks;
+        auto processorNs = juce::Time::highResolutionTicksToSeconds(processorTicks) * 1.0e9 / frames;
+        auto engineNs = juce::Time::highResolutionTicksToSeconds(engineTicks) * 1.0e9 / frames;
+
+        std::cout << "CPU: " << juce::SystemStats::getCpuModel() << "\n"
+                  << "Session: " << numTracks << " tracks, 48 kHz, " << blockSize << "-sample blocks, "
+                  << (config.linearDetector ? "linear" : "log") << " detector\n\n"
+                  << "  processors  " << juce::String(processorNs, 2).paddedLeft(' ', 8) << " ns/sample per track\n"
+                  << "  engine      " << juce::String(engineNs, 2).paddedLeft(' ', 8) << " ns/sample per track ("
+                  << juce::String(processorNs / juce::jmax(engineNs, 1.0e-9), 2) << "x)\n\n";
+
+        bool ok = true;
+
+        if (mismatchedSamples > 0 || latencyMismatches > 0)
+        {
+            std::cout << "FAIL: " << mismatchedSamples << " sample(s) differ (max " << maxDifference << "), "
+                      << latencyMismatches << " latency mismatch(es)" << std::endl;
+            ok = false;
+        }
+        else
+        {
+            std::cout << "Engine output is bit-identical to the processors" << std::endl;
+        }
+
+        if (allocations > 0)
+        {
+            std::cout << "FAIL: " << allocations << " allocation(s) on the audio thread" << std::endl;
+            ok = false;
+        }
+
+        return ok ? 0 : 1;
+    }
+
+    //==============================================================================
+    // Regression check: renders a fixed synthetic corpus through a few
+    // configurations, one with automation, and verifies that the output
+    // doesn't depend on the block size, that plosives are still found where
+    // they were injected, and that the sound matches a stored golden file.
+    struct Render
+    {
+        juce::AudioBuffer<float> output;
+        std::vector<PlosiveEvent> events;
+        double nsPerSample = 0.0;
+    };
+
+    // Parameter changes made while rendering with automation, after
+    // prepareToPlay. The last lands while the previous one is still gliding.
+    struct AutomationPoint
+    {
+        double seconds;
+        float thresholdDb, reductionPercent, frequencyHz;
+    };
+
+    const AutomationPoint automationPoints[] = { { 1.0, 12.0f, 40.0f, 320.0f },
+                                                 { 1.7, 3.0f, 90.0f, 140.0f },
+                                                 { 2.5, 9.0f, 60.0f, 240.0f },
+                                                 { 2.52, 15.0f, 75.0f, 180.0f } };
+
+    // Renders through an already prepared processor
+    Render render(PlosiveRemoverProcessor& processor, int blockSize, const juce::AudioBuffer<float>& source,
+                  bool automate = false)
+    {
+        Render result;
+        result.output.makeCopyOf(source);
+
+        const auto totalSamples = source.getNumSamples();
+        const auto sampleRate = processor.getSampleRate();
+        const int numPoints = automate ? juce::numElementsInArray(automationPoints) : 0;
+        int nextPoint = 0;
+        juce::MidiBuffer midi;
+        juce::int64 ticks = 0;
+
+        auto positionOf = [&](int point) { return juce::roundToInt(automationPoints[point].seconds * sampleRate); };
+
+        // The last block may be short, as hosts sometimes send. Automation
+        // splits the block at the change, as hosts with sample-accurate
+        // automation do, so every block size sees it at the same sample.
+        int length = 0;
+
+        for (int start = 0; start < totalSamples; start += length)
+        {
+            for (; nextPoint < numPoints && positionOf(nextPoint) <= start; ++nextPoint)
+            {
+                const auto& point = automationPoints[nextPoint];
+                *processor.threshold = point.thresholdDb;
+                *processor.reduction = point.reductionPercent;
+                *processor.frequency = point.frequencyHz;
+            }
+
+            length = std::min(blockSize, totalSamples - start);
+            if (nextPoint < numPoints)
+                length = std::min(length, positionOf(nextPoint) - start);
+
+            juce::AudioBuffer<float> block(result.output.getArrayOfWritePointers(), result.output.getNumChannels(),
+                                           start, length);
+
+            auto t0 = juce::Time::getHighResolutionTicks();
+            processor.processBlock(block, midi);
+            ticks += juce::Time::getHighResolutionTicks() - t0;
+
+            processor.eventQueue.drain([&](const PlosiveEvent& e) { result.events.push_back(e); });
+        }
+
+        processor.flushEvents();
+        processor.eventQueue.drain([&](const PlosiveEvent& e) { result.events.push_back(e); });
+
+        result.nsPerSample = juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9 / totalSamples;
+        return result;
+    }
+
+    Render render(const BenchmarkConfig& config, double sampleRate, int blockSize, const juce::AudioBuffer<float>& source)
+    {
+        PlosiveRemoverProcessor processor;
+        LoudnessProfile profile;
+        processor.setNonRealtime(config.twoPass);
+        prepareProcessor(processor, config, sampleRate, blockSize, source.getNumChannels(), false);
+
+        // The first pass reads the whole source, as PlosiveBatch --two-pass does
+        if (config.twoPass)
+        {
+            processor.beginLevelAnalysis(profile, source.getNumSamples());
+            processor.analyseLevels(source, source.getNumSamples(), profile);
+            profile.finish();
+            processor.setLevelProfile(&profile);
+        }
+
+        return render(processor, blockSize, source, config.automation);
+    }
+
+    // FNV-1a over the bit patterns of every output sample
+    juce::String hashOf(const juce::AudioBuffer<float>& buffer)
+    {
+        juce::uint64 hash = 14695981039346656037ull;
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            const auto* bytes = reinterpret_cast<const juce::uint8*>(buffer.getReadPointer(channel));
+
+            for (size_t i = 0; i < static_cast<size_t>(buffer.getNumSamples()) * sizeof(float); ++i)
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+
+        return juce::String::toHexString(static_cast<juce::int64>(hash)).paddedLeft('0', 16);
+    }
+
+    float maxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        float difference = 0.0f;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                difference = std::max(difference, std::abs(a.getSample(channel, i) - b.getSample(channel, i)));
+
+        return difference;
+    }
+
+    // Largest difference between two renders of the same source away from
+    // the plosives: outside 50 ms before to 100 ms after every injected
+    // plosive and every event either render reported. There both renders
+    // only delay the input, so they agree to within the gain smoother's last
+    // rounding steps, while audio that skipped processing differs by about
+    // the signal itself.
+    float differenceAwayFromPlosives(const Render& a, const Render& b,
+                                     const std::vector<SyntheticVoice::Plosive>& plosives, double sampleRate)
+    {
+        const auto numSamples = a.output.getNumSamples();
+        const auto before = static_cast<juce::int64>(sampleRate * 0.050);
+        const auto after = static_cast<juce::int64>(sampleRate * 0.100);
+        std::vector<bool> masked(static_cast<size_t>(numSamples), false);
+
+        auto mask = [&](juce::int64 start, juce::int64 end)
+        {
+            for (auto i = std::max<juce::int64>(0, start - before); i < std::min<juce::int64>(numSamples, end + after); ++i)
+                masked[static_cast<size_t>(i)] = true;
+        };
+
+        for (const auto& plosive : plosives)
+            mask(plosive.position, plosive.position + plosive.length);
+
+        for (const auto* events : { &a.events, &b.events })
+            for (const auto& e : *events)
+                mask(e.onsetSample, e.onsetSample + e.lengthSamples);
+
+        float difference = 0.0f;
+
+        for (int channel = 0; channel < a.output.getNumChannels(); ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                if (!masked[static_cast<size_t>(i)])
+                    difference = std::max(difference, std::abs(a.output.getSample(channel, i) - b.output.getSample(channel, i)));
+
+        return difference;
+    }
+
+    double rmsDb(const juce::AudioBuffer<float>& buffer)
+    {
+        double sum = 0.0;
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto rms = static_cast<double>(buffer.getRMSLevel(channel, 0, buffer.getNumSamples()));
+            sum += rms * rms;
+        }
+
+        return juce::Decibels::gainToDecibels(std::sqrt(sum / buffer.getNumChannels()), -200.0);
+    }
+
+    // Detected events against the injected plosives. A plosive is hit when an
+    // event opens during it (or up to 10 ms before, as the low-pass rings up);
+    // events that match no plosive are false alarms.
+    struct DetectionScore
+    {
+        int hits = 0;
+        int misses = 0;
+        int falseAlarms = 0;
+    };
+
+    DetectionScore score(const std::vector<PlosiveEvent>& events, const std::vector<SyntheticVoice::Plosive>& plosives,
+                         double sampleRate)
+    {
+        auto slack = static_cast<juce::int64>(sampleRate * 0.010);
+        std::vector<bool> matched(events.size(), false);
+        DetectionScore result;
+
+        for (const auto& plosive : plosives)
+        {
+            bool hit = false;
+
+            for (size_t e = 0; e < events.size(); ++e)
+            {
+                auto onset = events[e].onsetSample;
+
+                if (onset >= plosive.position - slack && onset < plosive.position + plosive.length)
+                {
+                    matched[e] = true;
+                    hit = true;
+                }
+            }
+
+            ++(hit ? result.hits : result.misses);
+        }
+
+        for (auto m : matched)
+            if (!m)
+                ++result.falseAlarms;
+
+        return result;
+    }
+
+    int runRegression(const BenchmarkConfig& config)
+    {
+        // Output must match bit for bit across block sizes, except with the
+        // linear detector, whose trigger level is computed once per block
+        const float blockSizeTolerance = config.linearDetector ? 0.002f : 0.0f;
+
+        // A golden mismatch still passes if the level is this close and every
+        // detection count agrees, as other compilers or CPUs may round differently
+        const double goldenRmsToleranceDb = 0.01;
+
+        // Two-pass against single-pass output away from the plosives (about -60 dBFS)
+        const float twoPassTolerance = 0.001f;
+
+        const std::vector<double> sampleRates = config.quick ? std::vector<double> { 48000.0 }
+                                                             : std::vector<double> { 44100.0, 48000.0, 96000.0 };
+        const std::vector<int> seeds { 1, 2, 3 };
+        const int referenceBlockSize = 512;
+        const std::vector<int> blockSizes { 32, 97, 2048 };
+
+        struct Variant
+        {
+            const char* name;
+            BenchmarkConfig config;
+        };
+
+        std::vector<Variant> variants { { "broadband", config }, { "split-band", config }, { "repair", config },
+                                        { "automation", config }, { "two-pass", config } };
+        variants[1].config.splitBand = true;
+        variants[2].config.repairFftSize = 512;
+        variants[3].config.splitBand = true;
+        variants[3].config.automation = true;
+        variants[4].config.twoPass = true;
+
+        // With --golden, every case must be in the file: a missing file or entry fails
+        const bool checkGolden = !config.updateGolden && config.goldenFile != juce::File();
+
+        juce::var golden;
+        if (checkGolden && config.goldenFile.existsAsFile())
+            golden = juce::JSON::parse(config.goldenFile);
+
+        auto* goldenResults = new juce::DynamicObject();
+        juce::var newGolden(goldenResults);
+
+        std::cout << "CPU: " << juce::SystemStats::getCpuModel() << "\n"
+                  << "Detector: " << (config.linearDetector ? "linear" : "log")
+                  << ", filter: " << (config.svfFilter ? "svf" : "biquad") << "\n"
+                  << "Golden: " << (config.goldenFile == juce::File() ? juce::String("none")
+                                    : config.goldenFile.getFullPathName()
+                                        + (config.updateGolden ? " (writing)" : golden.isObject() ? "" : " (missing)"))
+                  << "\n\n"
+                  << "  case                        hash              hits  miss  false   ns/sample  blocks  golden\n";
+
+        int failures = 0;
+
+        for (auto sampleRate : sampleRates)
+        {
+            for (auto seed : seeds)
+            {
+                juce::AudioBuffer<float> source(2, static_cast<int>(sampleRate * 4.0));
+                auto plosives = SyntheticVoice::generate(source, sampleRate, seed);
+
+                for (const auto& variant : variants)
+                {
+                    auto key = juce::String(sampleRate, 0) + "/seed" + juce::String(seed) + "/" + variant.name;
+                    auto reference = render(variant.config, sampleRate, referenceBlockSize, source);
+                    auto hash = hashOf(reference.output);
+                    auto level = rmsDb(reference.output);
+                    auto detection = score(reference.events, plosives, sampleRate);
+
+                    // Block-size independence, including odd and short blocks
+                    float worstDifference = 0.0f;
+                    for (auto blockSize : blockSizes)
+                        worstDifference = std::max(worstDifference,
+                                                   maxDifference(reference.output,
+                                                                 render(variant.config, sampleRate, blockSize, source).output));
+
+                    bool blocksOk = worstDifference <= blockSizeTolerance;
+
+                    // The whole-file references only move the threshold, so
+                    // away from the plosives a two-pass render must sound
+                    // like a single-pass one
+                    juce::String singlePassStatus;
+                    bool singlePassOk = true;
+
+                    if (variant.config.twoPass)
+                    {
+                        auto singlePassConfig = variant.config;
+                        singlePassConfig.twoPass = false;
+                        auto singlePass = render(singlePassConfig, sampleRate, referenceBlockSize, source);
+                        auto difference = differenceAwayFromPlosives(reference, singlePass, plosives, sampleRate);
+                        singlePassOk = difference <= twoPassTolerance;
+                        singlePassStatus = ", single pass " + (singlePassOk ? juce::String("ok")
+                                                                             : "FAIL (" + juce::String(difference) + ")");
+                    }
+
+                    auto* entry = new juce::DynamicObject();
+                    entry->setProperty("hash", hash);
+                    entry->setProperty("rms_db", level);
+                    entry->setProperty("hits", detection.hits);
+                    entry->setProperty("misses", detection.misses);
+                    entry->setProperty("false_alarms", detection.falseAlarms);
+                    entry->setProperty("ns_per_sample", reference.nsPerSample);
+                    goldenResults->setProperty(key, juce::var(entry));
+
+                    juce::String goldenStatus("-");
+                    bool goldenOk = true;
+                    auto expected = golden[juce::Identifier(key)];
+
+                    if (expected.isObject())
+                    {
+                        bool sameCounts = static_cast<int>(expected["hits"]) == detection.hits
+                                       && static_cast<int>(expected["misses"]) == detection.misses
+                                       && static_cast<int>(expected["false_alarms"]) == detection.falseAlarms;
+
+                        if (expected["hash"].toString() == hash)
+                            goldenStatus = "match";
+                        else if (sameCounts && std::abs(static_cast<double>(expected["rms_db"]) - level) <= goldenRmsToleranceDb)
+                            goldenStatus = "within tolerance";
+                        else
+                            goldenOk = false;
+
+                        if (!goldenOk)
+                            goldenStatus = "FAIL (was " + juce::String(static_cast<double>(expected["rms_db"]), 3)
+                                         + " dB, " + expected["hits"].toString() + "/" + expected["misses"].toString()
+                                         + "/" + expected["false_alarms"].toString() + ")";
+                    }
+                    else if (checkGolden)
+                    {
+                        goldenOk = false;
+                        goldenStatus = "FAIL (not in golden)";
+                    }
+
+                    if (!blocksOk || !goldenOk || !singlePassOk)
+                        ++failures;
+
+                    std::cout << "  " << key.paddedRight(' ', 28)
+                              << hash
+                              << juce::String(detection.hits).paddedLeft(' ', 6)
+                              << juce::String(detection.misses).paddedLeft(' ', 6)
+                              << juce::String(detection.falseAlarms).paddedLeft(' ', 7)
+                              << juce::String(reference.nsPerSample, 2).paddedLeft(' ', 12)
+                              << (blocksOk ? juce::String("      ok") : "  FAIL (" + juce::String(worstDifference) + ")")
+                              << "  " << goldenStatus << singlePassStatus << "\n";
+                }
+            }
+        }
+
+        std::cout << std::endl;
+
+        if (config.updateGolden && config.goldenFile != juce::File())
+        {
+            config.goldenFile.replaceWithText(juce::JSON::toString(newGolden));
+            std::cout << "Wrote " << config.goldenFile.getFullPathName() << std::endl;
+        }
+
+        if (failures > 0)
+        {
+            std::cout << "FAIL: " << failures << " case(s) changed" << std::endl;
+            return 1;
+        }
+
+        std::cout << "All cases passed" << std::endl;
+        return 0;
+    }
+
+    //==============================================================================
+    // Detector comparison: the gain curves of the log and linear detectors on
+    // three seeds of the synthetic voice, as PlosiveBatch --compare-detectors
+    // does for files. Fails if they differ by more than 0.01 dB anywhere.
+    int runDetectorComparison(const BenchmarkConfig& config)
+    {
+        const double toleranceDb = 0.01;
+        const int blockSize = 512;
+        const std::vector<double> sampleRates = config.quick ? std::vector<double> { 48000.0 }
+                                                             : std::vector<double> { 44100.0, 48000.0, 96000.0 };
+
+        std::cout << "CPU: " << juce::SystemStats::getCpuModel() << "\n"
+                  << "Block " << blockSize << "\n\n"
+                  << "  case              max deviation dB\n";
+
+        int failures = 0;
+
+        for (auto sampleRate : sampleRates)
+        {
+            for (int seed = 1; seed <= 3; ++seed)
+            {
+                juce::AudioBuffer<float> source(2, static_cast<int>(sampleRate * 4.0));
+                SyntheticVoice::generate(source, sampleRate, seed);
+                const auto totalSamples = source.getNumSamples();
+
+                PlosiveRemoverProcessor logProcessor, linearProcessor;
+                linearProcessor.setDetectorMode(PlosiveRemoverProcessor::DetectorMode::linearDomain);
+
+                for (auto* processor : { &logProcessor, &linearProcessor })
+                {
+                    processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+                    processor->prepareToPlay(sampleRate, blockSize);
+                }
+
+                // Same mono sum as processBlock
+                std::vector<float> mono(static_cast<size_t>(totalSamples));
+                juce::FloatVectorOperations::copy(mono.data(), source.getReadPointer(0), totalSamples);
+                juce::FloatVectorOperations::add(mono.data(), source.getReadPointer(1), totalSamples);
+                juce::FloatVectorOperations::multiply(mono.data(), 0.5f, totalSamples);
+
+                std::vector<float> logGain(mono.size()), linearGain(mono.size());
+                logProcessor.analyseGainCurve(mono.data(), logGain.data(), totalSamples);
+                linearProcessor.analyseGainCurve(mono.data(), linearGain.data(), totalSamples);
+
+                double deviationDb = 0.0;
+                for (size_t i = 0; i < mono.size(); ++i)
+                    deviationDb = std::max(deviationDb, std::abs(20.0 * std::log10(static_cast<double>(linearGain[i])
+                                                                                   / static_cast<double>(logGain[i]))));
+
+                bool ok = deviationDb <= toleranceDb;
+                if (!ok)
+                    ++failures;
+
+                auto key = juce::String(sampleRate, 0) + "/seed" + juce::String(seed);
+                std::cout << "  " << key.paddedRight(' ', 16)
+                          << juce::String(deviationDb, 5).paddedLeft(' ', 18)
+                          << (ok ? "" : "  FAIL") << "\n";
+            }
+        }
+
+        std::cout << std::endl;
+
+        if (failures > 0)
+        {
+            std::cout << "FAIL: " << failures << " case(s) differ by more than " << toleranceDb << " dB" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Detectors agree within " << toleranceDb << " dB" << std::endl;
+        return 0;
+    }
+
+    //==============================================================================
+    // Core equivalence: plosive::Processor<float, 2> against the plugin's
+    // default chain (stereo, linked, broadband, log detector) on three seeds
+    // of the test signal at a few settings. The core is a separate
+    // implementation the plugin doesn't run, so this is what keeps the two in
+    // step. PlosiveCore.h promises the same samples; a compiler that fuses
+    // multiply-adds differently in the two may move them by rounding, which
+    // the tolerance allows for.
+    int runCoreComparison(const BenchmarkConfig& config)
+    {
+        using CoreProcessor = plosive::Processor<float, 2>;
+
+        const float tolerance = 1.0e-5f;
+        const int blockSize = 512;
+        const std::vector<double> sampleRates = config.quick ? std::vector<double> { 48000.0 }
+                                                             : std::vector<double> { 44100.0, 48000.0, 96000.0 };
+
+        // Sensitivity dB, reduction %, frequency Hz, look-ahead ms
+        const CoreProcessor::Parameters settings[] = { { 6.0f, 70.0f, 200.0f, 5.0f },
+                                                       { 12.0f, 85.0f, 150.0f, 3.3f },
+                                                       { 18.0f, 50.0f, 320.0f, 11.0f } };
+
+        std::cout << "CPU: " << juce::SystemStats::getCpuModel() << "\n"
+                  << "plosive::Processor<float, 2> against the plugin, block " << blockSize << "\n\n"
+                  << "  case                      latency   differing   max difference\n";
+
+        int failures = 0;
+
+        for (auto sampleRate : sampleRates)
+        {
+            for (int seed = 1; seed <= 3; ++seed)
+            {
+                juce::AudioBuffer<float> source(2, static_cast<int>(sampleRate * 4.0));
+                SyntheticVoice::generate(source, sampleRate, seed);
+                const auto totalSamples = source.getNumSamples();
+
+                for (int s = 0; s < juce::numElementsInArray(settings); ++s)
+                {
+                    PlosiveRemoverProcessor plugin;
+                    *plugin.threshold = settings[s].sensitivityDb;
+                    *plugin.reduction = settings[s].reductionPercent;
+                    *plugin.frequency = settings[s].frequencyHz;
+                    *plugin.lookahead = settings[s].lookaheadMs;
+                    plugin.setRateAndBufferSizeDetails(sampleRate, blockSize);
+                    plugin.prepareToPlay(sampleRate, blockSize);
+
+                    // Read back the (quantised) parameter values so both sides use identical settings
+                    CoreProcessor::Parameters parameters;
+                    parameters.sensitivityDb = plugin.threshold->get();
+                    parameters.reductionPercent = plugin.reduction->get();
+                    parameters.frequencyHz = plugin.frequency->get();
+                    parameters.lookaheadMs = plugin.lookahead->get();
+
+                    CoreProcessor core;
+                    core.prepare(sampleRate);
+                    core.setParameters(parameters);
+
+                    juce::AudioBuffer<float> expected, output;
+                    expected.makeCopyOf(source);
+                    output.makeCopyOf(source);
+                    juce::MidiBuffer midi;
+
+                    for (int start = 0; start < totalSamples; start += blockSize)
+                    {
+                        auto numSamples = std::min(blockSize, totalSamples - start);
+                        juce::AudioBuffer<float> block(expected.getArrayOfWritePointers(), 2, start, numSamples);
+                        plugin.processBlock(block, midi);
+
+                        float* channels[] = { output.getWritePointer(0, start), output.getWritePointer(1, start) };
+                        core.process(channels, numSamples);
+                    }
+
+                    long differing = 0;
+                    float difference = 0.0f;
+                    for (int channel = 0; channel < output.getNumChannels(); ++channel)
+                    {
+                        for (int i = 0; i < totalSamples; ++i)
+                        {
+                            auto d = std::abs(output.getSample(channel, i) - expected.getSample(channel, i));
+                            differing += output.getSample(channel, i) != expected.getSample(channel, i) ? 1 : 0;
+                            difference = std::max(difference, d);
+                        }
+                    }
+
+                    bool latencyOk = core.getLatencySamples() == plugin.getLatencySamples();
+                    bool ok = latencyOk && difference <= tolerance;
+
+                    if (!ok)
+                        ++failures;
+
+                    auto key = juce::String(sampleRate, 0) + "/seed" + juce::String(seed) + "/settings" + juce::String(s + 1);
+                    std::cout << "  " << key.paddedRight(' ', 26)
+                              << (latencyOk ? juce::String("ok") : juce::String("FAIL")).paddedLeft(' ', 7)
+                              << juce::String(differing).paddedLeft(' ', 12)
+                              << juce::String(difference).paddedLeft(' ', 17)
+                              << (ok ? "" : "  FAIL") << "\n";
+                }
+            }
+        }
+
+        std::cout << std::endl;
+
+        if (failures > 0)
+        {
+            std::cout << "FAIL: " << failures << " case(s) differ from the plugin" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Core output matches the plugin" << std::endl;
+        return 0;
+    }
+
+    //==============================================================================
+    // Mid/side cost: whole-processBlock time of mid/side detection against
+    // linked, at 48 kHz stereo with 512-sample blocks, for broadband,
+    // split-band and repair. Fails if mid/side costs more than 1.5x linked
+    // in any of them, or allocates.
+    int runMidSideCost(const BenchmarkConfig& config)
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 512;
+        const int numChannels = 2;
+        const double maxRatio = 1.5;
+
+        juce::AudioBuffer<float> source(numChannels, static_cast<int>(sampleRate * config.seconds));
+        SyntheticVoice::generate(source, sampleRate);
+
+        struct Variant
+        {
+            const char* name;
+            BenchmarkConfig config;
+        };
+
+        Variant variants[] = { { "broadband", config }, { "split-band", config }, { "repair 1024", config } };
+        variants[1].config.splitBand = true;
+        variants[2].config.repairFftSize = 1024;
+
+        std::cout << "CPU: " << juce::SystemStats::getCpuModel() << "\n"
+                  << "Detector: " << (config.linearDetector ? "linear" : "log")
+                  << ", 48 kHz stereo, block " << blockSize << "\n\n"
+                  << "  case           linked ns   mid/side ns   ratio\n";
+
+        int failures = 0;
+
+        for (auto& variant : variants)
+        {
+            variant.config.linkMode = PlosiveRemoverProcessor::linked;
+            auto linked = run<float>(variant.config, sampleRate, blockSize, numChannels, source);
+            variant.config.linkMode = PlosiveRemoverProcessor::midSide;
+            auto midSide = run<float>(variant.config, sampleRate, blockSize, numChannels, source);
+
+            auto ratio = midSide.nsPerSample / juce::jmax(linked.nsPerSample, 1.0e-9);
+            bool ok = ratio <= maxRatio && linked.allocations == 0 && midSide.allocations == 0;
+
+            if (!ok)
+                ++failures;
+
+            std::cout << "  " << juce::String(variant.name).paddedRight(' ', 13)
+                      << juce::String(linked.nsPerSample, 2).paddedLeft(' ', 11)
+                      << juce::String(midSide.nsPerSample, 2).paddedLeft(' ', 14)
+                      << (juce::String(ratio, 2) + "x").paddedLeft(' ', 8)
+                      << (ok ? "" : "  FAIL") << "\n";
+        }
+
+        std::cout << std::endl;
+
+        if (failures > 0)
+        {
+            std::cout << "FAIL: mid/side over " << maxRatio << "x linked, or allocating, in "
+                      << failures << " case(s)" << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    //==============================================================================
+    // Gain-envelope cache check: renders the same input offline on one instance
+    // with the cache on (cold, again, then at another reduction) and requires
+    // each render to match a fresh uncached one bit for bit, and the second
+    // and third to run no detection at all
+    int runCacheCheck(const BenchmarkConfig& config)
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 512;
+        juce::AudioBuffer<float> source(2, static_cast<int>(sampleRate * juce::jmax(config.seconds, 10.0)));
+        SyntheticVoice::generate(source, sampleRate);
+
+        // The spectral gate keeps the cache out of use
+        const bool expectHits = !config.spectral;
+
+        struct Pass
+        {
+            const char* name;
+            float reductionPercent;
+        };
+
+        const Pass passes[] = { { "cold", 70.0f }, { "re-render", 70.0f }, { "reduction 40%", 40.0f } };
+
+        PlosiveRemoverProcessor cached;
+        cached.setNonRealtime(true);
+        cached.setGainCacheEnabled(true);
+
+        std::cout << "CPU: " << juce::SystemStats::getCpuModel() << "\n"
+                  << "Detector: " << (config.linearDetector ? "linear" : "log")
+                  << ", split band: " << (config.splitBand ? "on" : "off")
+                  << ", link: " << linkModeNames[config.linkMode]
+                  << ", " << juce::String(source.getNumSamples() / sampleRate, 0) << " s at 48 kHz, block " << blockSize
+                  << "\n\n"
+                  << "  pass             ns/sample   uncached    hits  misses   cache MB  output\n";
+
+        int failures = 0;
+
+        for (int p = 0; p < juce::numElementsInArray(passes); ++p)
+        {
+            const auto& pass = passes[p];
+
+            *cached.reduction = pass.reductionPercent;
+            prepareProcessor(cached, config, sampleRate, blockSize, source.getNumChannels(), false);
+            auto& cache = cached.getGainCache();
+            cache.resetCounters();
+            auto result = render(cached, blockSize, source);
+
+            PlosiveRemoverProcessor uncached;
+            uncached.setNonRealtime(true);
+            *uncached.reduction = pass.reductionPercent;
+            prepareProcessor(uncached, config, sampleRate, blockSize, source.getNumChannels(), false);
+            auto expected = render(uncached, blockSize, source);
+
+            bool identical = hashOf(result.output) == hashOf(expected.output)
+                          && result.events.size() == expected.events.size();
+            bool replayed = p == 0 || !expectHits || cache.getMisses() == 0;
+
+            if (!identical || !replayed)
+                ++failures;
+
+            std::cout << "  " << juce::String(pass.name).paddedRight(' ', 15)
+                      << juce::String(result.nsPerSample, 2).paddedLeft(' ', 11)
+                      << juce::String(expected.nsPerSample, 2).paddedLeft(' ', 11)
+                      << juce::String(cache.getHits()).paddedLeft(' ', 8)
+                      << juce::String(cache.getMisses()).paddedLeft(' ', 8)
+                      << juce::String(static_cast<double>(cache.getMemoryUsage()) / (1024.0 * 1024.0), 2).paddedLeft(' ', 11)
+                      << "  " << (identical ? juce::String("identical")
+                                            : "FAIL (" + juce::String(maxDifference(result.output, expected.output)) + ")")
+                      << (replayed ? "" : ", FAIL (detection re-ran)") << "\n";
+        }
+
+        std::cout << std::endl;
+
+        if (failures > 0)
+        {
+            std::cout << "FAIL: " << failures << " pass(es) differ" << std::endl;
+            return 1;
+        }
+
+        std::cout << "All passes matched" << std::endl;
+        return 0;
+    }
+
+    //==============================================================================
+    // Session load: restores one saved state into many instances, as a host
+    // opening a session does, from the binary format and from the XML that
+    // earlier versions saved. Fails unless every instance ends up with the
+    // saved settings.
+    int runStateLoad(const BenchmarkConfig& config)
+    {
+        const int numInstances = config.stateInstances;
+
+        PlosiveRemoverProcessor source;
+        *source.threshold = 13.5f;
+        *source.reduction = 55.0f;
+        *source.frequency = 260.0f;
+        *source.lookahead = 8.0f;
+        *source.splitBand = true;
+        *source.link = PlosiveRemoverProcessor::midSide;
+        *source.repairFftSize = 2;
+        *source.detectionFilter = 1;
+
+        juce::MemoryBlock binaryState, xmlState, defaultState;
+        source.getStateInformation(binaryState);
+
+        // What earlier versions saved: the parameter tree as XML
+        if (auto xml = source.parameters.copyState().createXml())
+            juce::AudioProcessor::copyXmlToBinary(*xml, xmlState);
+
+        std::vector<std::unique_ptr<PlosiveRemoverProcessor>> instances;
+        instances.reserve(static_cast<size_t>(numInstances));
+
+        auto t0 = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < numInstances; ++i)
+            instances.push_back(std::make_unique<PlosiveRemoverProcessor>());
+        auto constructSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - t0);
+
+        instances.front()->getStateInformation(defaultState);
+
+        struct Format
+        {
+            const char* name;
+            const juce::MemoryBlock* state;
+        };
+
+        const Format formats[] = { { "binary", &binaryState }, { "legacy XML", &xmlState } };
+
+        std::cout << "CPU: " << juce::SystemStats::getCpuModel() << "\n"
+                  << numInstances << " instances, constructed in "
+                  << juce::String(constructSeconds * 1.0e6 / numInstances, 1) << " us each\n\n"
+                  << "  format        bytes   us/instance   total ms  restored\n";
+
+        int failures = 0;
+
+        for (const auto& format : formats)
+        {
+            // Start every instance from the defaults, so each restore changes the same parameters
+            for (auto& instance : instances)
+                instance->setStateInformation(defaultState.getData(), static_cast<int>(defaultState.getSize()));
+
+            t0 = juce::Time::getHighResolutionTicks();
+            for (auto& instance : instances)
+                instance->setStateInformation(format.state->getData(), static_cast<int>(format.state->getSize()));
+            auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - t0);
+
+            // Binary states are deterministic, so equal bytes mean equal settings
+            int restored = 0;
+            for (auto& instance : instances)
+            {
+                juce::MemoryBlock state;
+                instance->getStateInformation(state);
+                restored += state == binaryState ? 1 : 0;
+            }
+
+            if (restored != numInstances)
+                ++failures;
+
+            std::cout << "  " << juce::String(format.name).paddedRight(' ', 12)
+                      << juce::String(static_cast<int>(format.state->getSize())).paddedLeft(' ', 7)
+                      << juce::String(seconds * 1.0e6 / numInstances, 2).paddedLeft(' ', 14)
+                      << juce::String(seconds * 1.0e3, 2).paddedLeft(' ', 11)
+                      << juce::String(restored).paddedLeft(' ', 10)
+                      << (restored == numInstances ? "" : "  FAIL") << "\n";
+        }
+
+        std::cout << std::endl;
+
+        if (failures > 0)
+        {
+            std::cout << "FAIL: " << failures << " format(s) didn't restore every instance" << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: PlosiveBenchmark [options]\n"
+                     "\n"
+                     "Times processBlock on a synthetic voice-plus-plosive signal for every\n"
+                     "combination of sample rate (44.1k/48k/96k/192k), block size (16-4096)\n"
+                     "and channel count (mono/stereo/5.1/16 discrete).\n"
+                     "\n"
+                     "Options:\n"
+                     "  --seconds <s>       Audio per measurement (default: 2)\n"
+                     "  --repeats <n>       Timed passes, best is reported (default: 3)\n"
+                     "  --detector linear   Use the linear-domain detector\n"
+                     "  --split-band        Enable split-band reduction\n"
+                     "  --spectral          Enable the spectral (FFT) detection gate\n"
+                     "  --link <mode>       linked, channel, pairs or midside detection (default: linked)\n"
+                     "  --repair <size>     Spectral repair with a 256/512/1024/2048-point FFT\n"
+                     "  --filter svf        Use the state-variable detection filter\n"
+                     "  --precision <p>     float, double or both (default: float)\n"
+                     "  --quick             48 kHz stereo, block sizes 64/512/4096 only\n"
+                     "  --session <n>       Instead of the matrix, run n tracks through one\n"
+                     "                      PlosiveSessionEngine and through n processors;\n"
+                     "                      fails unless the outputs are bit-identical\n"
+                     "  --regression        Instead of the matrix, render a fixed corpus through\n"
+                     "                      broadband, split-band, repair, automated settings\n"
+                     "                      and two-pass at several rates; fails if the output\n"
+                     "                      depends on the block size, differs from the --golden\n"
+                     "                      file or a two-pass render strays from single-pass\n"
+                     "  --cache             Instead of the matrix, render 10 s offline three times\n"
+                     "                      with the gain-envelope cache on; fails unless every\n"
+                     "                      render matches an uncached one bit for bit\n"
+                     "  --state [n]         Instead of the matrix, time restoring a saved state\n"
+                     "                      into n instances (default: 500), binary and legacy XML\n"
+                     "  --golden <file>     Regression results to compare against\n"
+                     "  --update-golden     Write the --golden file from this run\n"
+                     "  --compare-detectors Instead of the matrix, run the log and linear\n"
+                     "                      detectors over three seeds of the test signal; fails\n"
+                     "                      if their gains differ by more than 0.01 dB\n"
+                     "  --core              Instead of the matrix, run plosive::Processor<float, 2>\n"
+                     "                      and the plugin over three seeds of the test signal;\n"
+                     "                      fails unless they match\n"
+                     "  --midside-cost      Instead of the matrix, time mid/side against linked\n"
+                     "                      detection at 48 kHz stereo (broadband, split-band,\n"
+                     "                      repair); fails above 1.5x\n"
+                     "  --csv <file>        Also write results as CSV\n"
+                     "  --profile <file>    Write per-stage timing histograms as JSON" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    BenchmarkConfig config;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(argv[i]);
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--seconds" && hasValue)
+            config.seconds = juce::jmax(0.1, juce::String(argv[++i]).getDoubleValue());
+        else if (arg == "--repeats" && hasValue)
+            config.repeats = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--detector" && hasValue)
+            config.linearDetector = juce::String(argv[++i]) == "linear";
+        else if (arg == "--split-band")
+            config.splitBand = true;
+        else if (arg == "--spectral")
+            config.spectral = true;
+        else if (arg == "--link" && hasValue)
+        {
+            juce::String mode(argv[++i]);
+            config.linkMode = mode == "channel" ? PlosiveRemoverProcessor::perChannel
+                            : mode == "pairs"   ? PlosiveRemoverProcessor::pairs
+                            : mode == "midside" ? PlosiveRemoverProcessor::midSide
+                                                : PlosiveRemoverProcessor::linked;
+        }
+        else if (arg == "--repair" && hasValue)
+        {
+            auto size = juce::String(argv[++i]).getIntValue();
+            config.repairFftSize = juce::isPowerOfTwo(size) ? juce::jlimit(1 << SpectralRepair::MIN_ORDER,
+                                                                           SpectralRepair::MAX_FFT_SIZE, size)
+                                                            : 0;
+        }
+        else if (arg == "--filter" && hasValue)
+            config.svfFilter = juce::String(argv[++i]) == "svf";
+        else if (arg == "--precision" && hasValue)
+        {
+            juce::String precision(argv[++i]);
+            config.singlePrecision = precision != "double";
+            config.doublePrecision = precision == "double" || precision == "both";
+        }
+        else if (arg == "--session" && hasValue)
+            config.sessionTracks = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--quick")
+            config.quick = true;
+        else if (arg == "--regression")
+            config.regression = true;
+        else if (arg == "--cache")
+            config.cache = true;
+        else if (arg == "--state")
+            config.stateInstances = hasValue && juce::String(argv[i + 1]).containsOnly("0123456789")
+                                        ? juce::jmax(1, juce::String(argv[++i]).getIntValue())
+                                        : 500;
+        else if (arg == "--golden" && hasValue)
+            config.goldenFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--update-golden")
+            config.updateGolden = true;
+        else if (arg == "--compare-detectors")
+            config.compareDetectors = true;
+        else if (arg == "--core")
+            config.core = true;
+        else if (arg == "--midside-cost")
+            config.midSideCost = true;
+        else if (arg == "--csv" && hasValue)
+            config.csvFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--profile" && hasValue)
+            config.profileFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else
+        {
+            printUsage();
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (config.sessionTracks > 0)
+        return runSession(config);
+
+    if (config.compareDetectors)
+        return runDetectorComparison(config);
+
+    if (config.core)
+        return runCoreComparison(config);
+
+    if (config.midSideCost)
+        return runMidSideCost(config);
+
+    if (config.regression)
+        return runRegression(config);
+
+    if (config.cache)
+        return runCacheCheck(config);
+
+    if (config.stateInstances > 0)
+        return runStateLoad(config);
+
+    std::vector<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+    std::vector<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    std::vector<int> channelCounts { 1, 2, 6, 16 };
+
+    if (config.quick)
+    {
+        sampleRates = { 48000.0 };
+        blockSizes = { 64, 512, 4096 };
+        channelCounts = { 2 };
+    }
+
+    std::cout << "CPU: " << juce::SystemStats::getCpuModel() << "\n"
+              << "Detector: " << (config.linearDetector ? "linear" : "log")
+              << ", split band: " << (config.splitBand ? "on" : "off")
+              << ", spectral: " << (config.spectral ? "on" : "off")
+              << ", link: " << linkModeNames[config.linkMode]
+              << ", repair: " << (config.repairFftSize > 0 ? juce::String(config.repairFftSize) : juce::String("off"))
+              << ", filter: " << (config.svfFilter ? "svf" : "biquad") << "\n\n"
+              << "   rate  block  ch  precision   ns/sample   realtime x   allocs\n";
+
+    juce::String csv = "sample_rate,block_size,channels,precision,ns_per_sample,realtime_factor,allocations\n";
+
+    std::vector<bool> precisions;
+    if (config.singlePrecision)
+        precisions.push_back(false);
+    if (config.doublePrecision)
+        precisions.push_back(true);
+    juce::String profiles;
+    long totalAllocations = 0;
+
+    for (auto sampleRate : sampleRates)
+    {
+        for (auto numChannels : channelCounts)
+        {
+            juce::AudioBuffer<float> source(numChannels, static_cast<int>(sampleRate * config.seconds));
+            SyntheticVoice::generate(source, sampleRate);
+
+            for (auto blockSize : blockSizes)
+            {
+                for (auto isDouble : precisions)
+                {
+                    auto m = isDouble ? run<double>(config, sampleRate, blockSize, numChannels, source)
+                                      : run<float>(config, sampleRate, blockSize, numChannels, source);
+                    totalAllocations += m.allocations;
+
+                    juce::String precisionName(isDouble ? "double" : "float");
+
+                    std::cout << juce::String(sampleRate / 1000.0, 1).paddedLeft(' ', 6) << "k"
+                              << juce::String(blockSize).paddedLeft(' ', 7)
+                              << juce::String(numChannels).paddedLeft(' ', 4)
+                              << precisionName.paddedLeft(' ', 11)
+                              << juce::String(m.nsPerSample, 2).paddedLeft(' ', 12)
+                              << juce::String(m.realtimeFactor, 0).paddedLeft(' ', 13)
+                              << juce::String(m.allocations).paddedLeft(' ', 9) << "\n";
+
+                    csv << juce::String(sampleRate, 0) << "," << blockSize << "," << numChannels << ","
+                        << precisionName << "," << juce::String(m.nsPerSample, 3) << ","
+                        << juce::String(m.realtimeFactor, 1) << "," << juce::String(m.allocations) << "\n";
+
+                    profiles << (profiles.isEmpty() ? "[\n" : ",\n")
+                             << "{ \"sample_rate\": " << juce::String(sampleRate, 0)
+                             << ", \"block_size\": " << blockSize
+                             << ", \"channels\": " << numChannels
+                             << ", \"precision\": \"" << precisionName << "\""
+                             << ", \"profile\": " << m.profile.trim() << " }";
+                }
+            }
+        }
+    }
+
+    std::cout << std::endl;
+
+    if (config.csvFile != juce::File())
+        config.csvFile.replaceWithText(csv);
+
+    if (config.profileFile != juce::File())
+        config.profileFile.replaceWithText(profiles + "\n]\n");
+
+    if (totalAllocations > 0)
+    {
+        std::cout << "FAIL: " << totalAllocations << " allocation(s) inside processBlock" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "../Core/PlosiveCore.h"
+#include "../Core/PlosiveCoreC.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Times the JUCE-free core on its own: plosive::Processor in float and
+// double, and the C interface, at 48 kHz stereo. Builds without JUCE.
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+
+    // Noise floor with a decaying 70 Hz burst every 0.6 s
+    template <typename Sample>
+    std::vector<std::vector<Sample>> makeSignal(int numSamples)
+    {
+        std::mt19937 rng(1);
+        std::normal_distribution<double> noise(0.0, 0.02);
+        std::vector<std::vector<Sample>> channels(numChannels, std::vector<Sample>(static_cast<size_t>(numSamples)));
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto k = i % static_cast<int>(sampleRate * 0.6);
+            auto burst = k < 2400 ? 0.7 * std::exp(-k / 600.0) * std::sin(2.0 * 3.14159265358979 * 70.0 * k / sampleRate) : 0.0;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                channels[static_cast<size_t>(channel)][static_cast<size_t>(i)] = static_cast<Sample>(burst + noise(rng));
+        }
+
+        return channels;
+    }
+
+    template <typename Process>
+    double timeRun(int numSamples, int blockSize, int repeats, Process&& process)
+    {
+        double best = 1.0e30;
+
+        for (int pass = 0; pass <= repeats; ++pass)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            for (int offset = 0; offset + blockSize <= numSamples; offset += blockSize)
+                process(offset, blockSize);
+
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (pass > 0) // pass 0 warms up
+                best = std::min(best, elapsed.count());
+        }
+
+        return best * 1.0e9 / static_cast<double>((numSamples / blockSize) * blockSize);
+    }
+
+    template <typename Sample>
+    double runTemplate(int numSamples, int blockSize, int repeats)
+    {
+        auto signal = makeSignal<Sample>(numSamples);
+        plosive::Processor<Sample, numChannels> processor;
+        processor.prepare(sampleRate);
+
+        return timeRun(numSamples, blockSize, repeats, [&](int offset, int n) {
+            Sample* channels[numChannels];
+            for (int channel = 0; channel < numChannels; ++channel)
+                channels[channel] = signal[static_cast<size_t>(channel)].data() + offset;
+
+            processor.process(channels, n);
+        });
+    }
+
+    double runC(int numSamples, int blockSize, int repeats)
+    {
+        auto signal = makeSignal<float>(numSamples);
+        auto* core = plosive_core_create(numChannels);
+        plosive_core_prepare(core, sampleRate);
+
+        auto ns = timeRun(numSamples, blockSize, repeats, [&](int offset, int n) {
+            float* channels[numChannels];
+            for (int channel = 0; channel < numChannels; ++channel)
+                channels[channel] = signal[static_cast<size_t>(channel)].data() + offset;
+
+            plosive_core_process(core, channels, n);
+        });
+
+        plosive_core_destroy(core);
+        return ns;
+    }
+
+    void report(const char* name, double nsPerSample)
+    {
+        auto realtime = 1.0e9 / (nsPerSample * sampleRate);
+        std::cout << "  " << name << std::string(16 - std::string(name).size(), ' ')
+                  << nsPerSample << " ns/sample, " << static_cast<long>(realtime) << "x realtime\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int blockSize = 512;
+    double seconds = 2.0;
+    int repeats = 3;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--block-size" && hasValue)
+            blockSize = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--seconds" && hasValue)
+            seconds = std::max(0.1, std::atof(argv[++i]));
+        else if (arg == "--repeats" && hasValue)
+            repeats = std::max(1, std::atoi(argv[++i]));
+        else
+        {
+            std::cout << "Usage: PlosiveCoreBenchmark [--block-size <n>] [--seconds <s>] [--repeats <n>]\n";
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    auto numSamples = static_cast<int>(sampleRate * seconds);
+
+    std::cout << "48 kHz stereo, " << blockSize << "-sample blocks\n";
+    report("float", runTemplate<float>(numSamples, blockSize, repeats));
+    report("double", runTemplate<double>(numSamples, blockSize, repeats));
+    report("C API (float)", runC(numSamples, blockSize, repeats));
+    return 0;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cmath>
+#include <vector>
+
+// Deterministic voice-plus-plosive test signal: a gliding harmonic "voice" in
+// syllable-rate bursts over a low noise floor, with low-frequency pops injected
+// at known positions. The same seed always produces the same samples.
+struct SyntheticVoice
+{
+    struct Plosive
+    {
+        juce::int64 position;   // first sample of the burst
+        int length;             // samples until it has decayed by ~40 dB
+    };
+
+    // Fills every channel of `buffer` (channels get slightly different gains so
+    // the stereo image isn't perfectly mono) and returns the injected plosives
+    static std::vector<Plosive> generate(juce::AudioBuffer<float>& buffer, double sampleRate,
+                                         juce::int64 seed = 1, double plosivesPerSecond = 1.5)
+    {
+        const auto numSamples = buffer.getNumSamples();
+        const auto numChannels = buffer.getNumChannels();
+        const auto twoPi = juce::MathConstants<double>::twoPi;
+
+        juce::Random random(seed);
+        std::vector<float> mono(static_cast<size_t>(numSamples));
+
+        // Voice: 8 harmonics, f0 gliding around 160 Hz, 4 Hz syllables
+        double phase = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double t = i / sampleRate;
+            double f0 = 160.0 + 30.0 * std::sin(twoPi * 0.7 * t);
+            phase += twoPi * f0 / sampleRate;
+
+            double voice = 0.0;
+            for (int h = 1; h <= 8; ++h)
+                voice += std::sin(phase * h) / h;
+
+            double syllable = 0.5 + 0.5 * std::sin(twoPi * 4.0 * t);
+            double noise = (random.nextFloat() * 2.0f - 1.0f) * 0.002;
+            mono[static_cast<size_t>(i)] = static_cast<float>(0.12 * syllable * syllable * voice + noise);
+        }
+
+        // Plosives: decaying 40-90 Hz thumps with a short noise onset, spaced
+        // with some jitter so they land on different block offsets
+        std::vector<Plosive> plosives;
+        const auto spacing = static_cast<juce::int64>(sampleRate / plosivesPerSecond);
+        const auto decaySamples = sampleRate * 0.012;
+        const auto length = static_cast<int>(decaySamples * 4.6); // e^-4.6 ~ -40 dB
+
+        for (auto pos = spacing / 2; pos + length < numSamples; pos += spacing)
+        {
+            auto position = pos + static_cast<juce::int64>(random.nextInt(static_cast<int>(spacing / 4)));
+            if (position + length >= numSamples)
+                break;
+
+            double freq = 40.0 + 50.0 * random.nextDouble();
+            double amplitude = 0.4 + 0.5 * random.nextDouble();
+
+            for (int i = 0; i < length; ++i)
+            {
+                double env = std::exp(-i / decaySamples);
+                double thump = std::sin(twoPi * freq * i / sampleRate);
+                double burst = (i < length / 8) ? (random.nextFloat() * 2.0f - 1.0f) * 0.3 : 0.0;
+                mono[static_cast<size_t>(position + i)] += static_cast<float>(amplitude * env * (thump + burst));
+            }
+
+            plosives.push_back({ position, length });
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto gain = 1.0f - 0.1f * static_cast<float>(channel % 2);
+            juce::FloatVectorOperations::copyWithMultiply(buffer.getWritePointer(channel), mono.data(), gain, numSamples);
+        }
+
+        return plosives;
+    }
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cmath>
+#include <vector>
+
+// cos/sin of w0 = 2*pi*fc/fs, precomputed at 1 Hz steps over a cutoff range.
+// Lets biquad coefficients follow an automated cutoff every few samples
+// without calling transcendental functions on the audio thread.
+class BiquadTrigTable
+{
+public:
+    // Allocates; call from prepareToPlay
+    void prepare(double sampleRate, float minCutoffHz, float maxCutoffHz)
+    {
+        minHz = minCutoffHz;
+        auto numEntries = static_cast<size_t>(std::ceil(maxCutoffHz - minCutoffHz)) + 2;
+
+        cosValues.resize(numEntries);
+        sinValues.resize(numEntries);
+
+        for (size_t i = 0; i < numEntries; ++i)
+        {
+            double w0 = juce::MathConstants<double>::twoPi * (minHz + static_cast<double>(i)) / sampleRate;
+            cosValues[i] = static_cast<float>(std::cos(w0));
+            sinValues[i] = static_cast<float>(std::sin(w0));
+        }
+    }
+
+    // Linear interpolation between the two nearest 1 Hz entries
+    void lookup(float cutoffHz, float& cosw0, float& sinw0) const
+    {
+        auto maxPos = static_cast<float>(cosValues.size() - 2);
+        auto pos = juce::jlimit(0.0f, maxPos, cutoffHz - minHz);
+        auto index = static_cast<size_t>(pos);
+        auto frac = pos - static_cast<float>(index);
+
+        cosw0 = cosValues[index] + frac * (cosValues[index + 1] - cosValues[index]);
+        sinw0 = sinValues[index] + frac * (sinValues[index + 1] - sinValues[index]);
+    }
+
+private:
+    float minHz = 0.0f;
+    std::vector<float> cosValues, sinValues;
+};
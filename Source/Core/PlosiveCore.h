@@ -0,0 +1,302 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// The plosive remover's DSP without JUCE: header-only, templated on the
+// sample type, and free of allocation (all storage is sized at compile time).
+//
+// PlosiveDetector takes its coefficient design from the building blocks
+// below. plosive::Processor puts them together into the plugin's default
+// chain (linked detection, broadband reduction) for a fixed channel count.
+// The plugin doesn't run Processor; it is a parallel implementation, kept in
+// step with the plugin only by the plosive_core ctest (PlosiveBenchmark
+// --core). PlosiveCoreC.h wraps it in a C ABI.
+namespace plosive
+{
+    // Detector constants
+    constexpr float SENSITIVITY_RANGE_DB = 24.0f;  // sensitivity 0 triggers this far above the average level
+    constexpr float FULL_REDUCTION_DB = 6.0f;      // excess over the trigger threshold for full reduction
+    constexpr float TRIGGER_FLOOR_DB = -40.0f;     // envelopes below this never trigger
+    constexpr float LEVEL_FLOOR = 0.00001f;        // -100 dB; quieter levels read as -100 dB
+    constexpr float MIN_GAIN = 0.05f;              // deepest reduction, about -26 dB
+
+    template <typename Sample>
+    constexpr Sample pi = static_cast<Sample>(3.141592653589793238L);
+
+    // One-pole coefficient for a time constant
+    template <typename Sample>
+    inline Sample timeConstantCoefficient(Sample sampleRate, Sample seconds)
+    {
+        return Sample(1) - std::exp(Sample(-1) / (sampleRate * seconds));
+    }
+
+    // RBJ low-pass biquad coefficients (normalised by a0)
+    template <typename Sample>
+    struct LowPassCoefficients
+    {
+        Sample b0 = 0, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+
+        static LowPassCoefficients fromTrig(Sample cosw0, Sample sinw0, Sample q)
+        {
+            Sample alpha = sinw0 / (Sample(2) * q);
+            Sample a0 = Sample(1) + alpha;
+
+            LowPassCoefficients c;
+            c.b0 = ((Sample(1) - cosw0) / Sample(2)) / a0;
+            c.b1 = (Sample(1) - cosw0) / a0;
+            c.b2 = c.b0;
+            c.a1 = (Sample(-2) * cosw0) / a0;
+            c.a2 = (Sample(1) - alpha) / a0;
+            return c;
+        }
+
+        static LowPassCoefficients design(Sample cutoffHz, Sample q, Sample sampleRate)
+        {
+            Sample w0 = Sample(2) * pi<Sample> * cutoffHz / sampleRate;
+            return fromTrig(std::cos(w0), std::sin(w0), q);
+        }
+    };
+
+    // Envelope follower step with separate attack and release coefficients
+    template <typename Sample>
+    inline Sample followEnvelope(Sample envelope, Sample input, Sample attack, Sample release)
+    {
+        return envelope + (input > envelope ? attack : release) * (input - envelope);
+    }
+
+    // Level in dB, floored at -100 dB
+    template <typename Sample>
+    inline Sample levelToDb(Sample level)
+    {
+        return level > Sample(LEVEL_FLOOR) ? Sample(20) * std::log10(level) : Sample(-100);
+    }
+
+    // Share of the full reduction for an excess over the trigger threshold
+    template <typename Sample>
+    inline Sample reductionRatio(Sample excessDb)
+    {
+        return std::min(Sample(1), excessDb / Sample(FULL_REDUCTION_DB));
+    }
+
+    // Target gain for a reduction ratio and the reduction amount (0-1)
+    template <typename Sample>
+    inline Sample targetGain(Sample ratio, Sample reductionAmount)
+    {
+        return std::max(Sample(MIN_GAIN), Sample(1) - (reductionAmount * ratio));
+    }
+
+    // Gain smoother step: fast towards more reduction, slower on recovery
+    template <typename Sample>
+    inline Sample smoothGain(Sample current, Sample target, Sample coefficient)
+    {
+        return current + coefficient * (target < current ? Sample(2) : Sample(0.3)) * (target - current);
+    }
+
+    // Soft knee: blend of linear and squared gain for a smoother perceived change
+    template <typename Sample>
+    inline Sample softKnee(Sample gain)
+    {
+        Sample squared = gain * gain;
+        return squared * Sample(0.5) + gain * Sample(0.5);
+    }
+
+    // Single-unit detector in the log domain: mono detection input in,
+    // per-sample gain out.
+    template <typename Sample>
+    class Detector
+    {
+    public:
+        void prepare(double sampleRate)
+        {
+            fs = static_cast<Sample>(sampleRate);
+
+            fastAttack = timeConstantCoefficient(fs, Sample(0.001));
+            fastRelease = timeConstantCoefficient(fs, Sample(0.030));
+            slowAttack = timeConstantCoefficient(fs, Sample(0.020));
+            slowRelease = timeConstantCoefficient(fs, Sample(0.100));
+            gainSmoothCoeff = timeConstantCoefficient(fs, Sample(0.003));
+            avgLevelCoeff = timeConstantCoefficient(fs, Sample(0.5));
+
+            reset();
+        }
+
+        void reset()
+        {
+            z1 = z2 = fast = slow = avg = Sample(0);
+            current = Sample(1);
+        }
+
+        void setLowPass(Sample cutoffHz, Sample q)
+        {
+            lowPass = LowPassCoefficients<Sample>::design(cutoffHz, q, fs);
+        }
+
+        void setSensitivity(Sample sensitivityDb) { thresholdOffsetDb = Sample(SENSITIVITY_RANGE_DB) - sensitivityDb; }
+        void setReduction(Sample amount) { reduction = amount; }
+
+        Sample process(Sample input)
+        {
+            Sample lowFreq = lowPass.b0 * input + lowPass.b1 * z1 + lowPass.b2 * z2 - lowPass.a1 * z1 - lowPass.a2 * z2;
+            z2 = z1;
+            z1 = lowFreq;
+
+            Sample lowFreqAbs = std::abs(lowFreq);
+            fast = followEnvelope(fast, lowFreqAbs, fastAttack, fastRelease);
+            slow = followEnvelope(slow, lowFreqAbs, slowAttack, slowRelease);
+            avg += avgLevelCoeff * (lowFreqAbs - avg);
+
+            Sample envelopeDb = levelToDb(fast);
+            Sample triggerDb = levelToDb(avg) + thresholdOffsetDb;
+            Sample target = Sample(1);
+
+            if (envelopeDb > triggerDb && envelopeDb > Sample(TRIGGER_FLOOR_DB))
+                target = targetGain(reductionRatio(envelopeDb - triggerDb), reduction);
+
+            current = smoothGain(current, target, gainSmoothCoeff);
+            return softKnee(current);
+        }
+
+        Sample getEnvelope() const { return fast; }
+
+    private:
+        Sample fs = Sample(44100);
+        LowPassCoefficients<Sample> lowPass;
+        Sample fastAttack = 0, fastRelease = 0, slowAttack = 0, slowRelease = 0;
+        Sample gainSmoothCoeff = 0, avgLevelCoeff = 0;
+        Sample thresholdOffsetDb = Sample(SENSITIVITY_RANGE_DB - 6.0f);
+        Sample reduction = Sample(0.7);
+
+        Sample z1 = 0, z2 = 0, fast = 0, slow = 0, avg = 0, current = 1;
+    };
+
+    // Fixed-capacity multichannel delay; Capacity must be a power of two
+    template <typename Sample, int NumChannels, int Capacity>
+    class DelayLine
+    {
+    public:
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+        void reset()
+        {
+            for (auto& line : lines)
+                line.fill(Sample(0));
+
+            writePos = 0;
+        }
+
+        // Writes one frame and returns, per channel, the frame delaySamples earlier
+        // (0 <= delaySamples < Capacity)
+        void process(Sample* frame, int delaySamples)
+        {
+            auto readPos = (writePos - delaySamples) & (Capacity - 1);
+
+            for (int channel = 0; channel < NumChannels; ++channel)
+            {
+                lines[static_cast<size_t>(channel)][static_cast<size_t>(writePos)] = frame[channel];
+                frame[channel] = lines[static_cast<size_t>(channel)][static_cast<size_t>(readPos)];
+            }
+
+            writePos = (writePos + 1) & (Capacity - 1);
+        }
+
+    private:
+        std::array<std::array<Sample, static_cast<size_t>(Capacity)>, static_cast<size_t>(NumChannels)> lines {};
+        int writePos = 0;
+    };
+
+    // The plugin's default chain for NumChannels channels: the channels'
+    // average drives one detector and every channel gets its gain after the
+    // look-ahead delay. 4096 samples of delay cover the 20 ms look-ahead up
+    // to 192 kHz. For Sample = float, the output matches PlosiveRemoverProcessor
+    // with the same settings bit for bit, provided both are built without
+    // multiply-add contraction into FMA (GCC's -ffp-contract=fast with FMA
+    // enabled can fuse the two differently).
+    template <typename Sample, int NumChannels, int MaxDelaySamples = 4096>
+    class Processor
+    {
+    public:
+        static_assert(NumChannels > 0, "at least one channel");
+
+        static constexpr float MIN_LOOKAHEAD_MS = 1.0f;
+        static constexpr float MAX_LOOKAHEAD_MS = 20.0f;
+
+        struct Parameters
+        {
+            Sample sensitivityDb = Sample(6);    // 0-24
+            Sample reductionPercent = Sample(70);
+            Sample frequencyHz = Sample(200);    // 100-400
+            Sample lookaheadMs = Sample(5);      // 1-20
+        };
+
+        // Doesn't allocate; may be called again at any time to change rate
+        void prepare(double newSampleRate)
+        {
+            sampleRate = newSampleRate;
+            maxLookaheadSamples = std::min(static_cast<int>(std::ceil(sampleRate * MAX_LOOKAHEAD_MS / 1000.0)),
+                                           MaxDelaySamples - 1);
+            detector.prepare(sampleRate);
+            setParameters(parameters);
+            reset();
+        }
+
+        void reset()
+        {
+            detector.reset();
+            delay.reset();
+        }
+
+        void setParameters(const Parameters& newParameters)
+        {
+            parameters = newParameters;
+
+            // Same detection cutoff (1.5x) and Q as the plugin
+            detector.setLowPass(parameters.frequencyHz * Sample(1.5), Sample(0.5));
+            detector.setSensitivity(parameters.sensitivityDb);
+            detector.setReduction(parameters.reductionPercent / Sample(100));
+
+            auto ms = std::clamp(static_cast<double>(parameters.lookaheadMs),
+                                 static_cast<double>(MIN_LOOKAHEAD_MS), static_cast<double>(MAX_LOOKAHEAD_MS));
+            lookaheadSamples = std::min(static_cast<int>(sampleRate * ms / 1000.0), maxLookaheadSamples);
+        }
+
+        const Parameters& getParameters() const { return parameters; }
+        int getLatencySamples() const { return lookaheadSamples; }
+
+        // In place, any number of samples
+        void process(Sample* const* channels, int numSamples)
+        {
+            const Sample scale = Sample(1) / static_cast<Sample>(NumChannels);
+            Sample frame[static_cast<size_t>(NumChannels)];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                Sample mono = channels[0][i];
+                for (int channel = 1; channel < NumChannels; ++channel)
+                    mono += channels[channel][i];
+
+                if (NumChannels > 1)
+                    mono *= scale;
+
+                Sample gain = detector.process(mono);
+
+                for (int channel = 0; channel < NumChannels; ++channel)
+                    frame[channel] = channels[channel][i];
+
+                delay.process(frame, lookaheadSamples);
+
+                for (int channel = 0; channel < NumChannels; ++channel)
+                    channels[channel][i] = frame[channel] * gain;
+            }
+        }
+
+    private:
+        double sampleRate = 44100.0;
+        int maxLookaheadSamples = 0;
+        int lookaheadSamples = 0;
+        Parameters parameters;
+        Detector<Sample> detector;
+        DelayLine<Sample, NumChannels, MaxDelaySamples> delay;
+    };
+}
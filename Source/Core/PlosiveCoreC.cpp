@@ -0,0 +1,79 @@
+#include "PlosiveCoreC.h"
+#include "PlosiveCore.h"
+#include <new>
+
+struct plosive_core
+{
+    virtual ~plosive_core() = default;
+    virtual void prepare(double sampleRate) = 0;
+    virtual void reset() = 0;
+    virtual void setParameters(const plosive_core_params& params) = 0;
+    virtual int getLatencySamples() const = 0;
+    virtual void process(float* const* channels, int numSamples) = 0;
+};
+
+namespace
+{
+    template <int NumChannels>
+    struct CoreInstance final : plosive_core
+    {
+        using Processor = plosive::Processor<float, NumChannels>;
+
+        void prepare(double sampleRate) override { processor.prepare(sampleRate); }
+        void reset() override { processor.reset(); }
+        int getLatencySamples() const override { return processor.getLatencySamples(); }
+        void process(float* const* channels, int numSamples) override { processor.process(channels, numSamples); }
+
+        void setParameters(const plosive_core_params& params) override
+        {
+            typename Processor::Parameters p;
+            p.sensitivityDb = params.sensitivity_db;
+            p.reductionPercent = params.reduction_percent;
+            p.frequencyHz = params.frequency_hz;
+            p.lookaheadMs = params.lookahead_ms;
+            processor.setParameters(p);
+        }
+
+        Processor processor;
+    };
+
+    template <int NumChannels>
+    plosive_core* createInstance(int numChannels)
+    {
+        if constexpr (NumChannels > PLOSIVE_CORE_MAX_CHANNELS)
+            return nullptr;
+        else if (numChannels == NumChannels)
+            return new (std::nothrow) CoreInstance<NumChannels>();
+        else
+            return createInstance<NumChannels + 1>(numChannels);
+    }
+}
+
+extern "C"
+{
+    void plosive_core_default_params(plosive_core_params* params)
+    {
+        plosive::Processor<float, 1>::Parameters defaults;
+        params->sensitivity_db = defaults.sensitivityDb;
+        params->reduction_percent = defaults.reductionPercent;
+        params->frequency_hz = defaults.frequencyHz;
+        params->lookahead_ms = defaults.lookaheadMs;
+    }
+
+    plosive_core* plosive_core_create(int num_channels)
+    {
+        return createInstance<1>(num_channels);
+    }
+
+    void plosive_core_destroy(plosive_core* core) { delete core; }
+
+    void plosive_core_prepare(plosive_core* core, double sample_rate) { core->prepare(sample_rate); }
+    void plosive_core_reset(plosive_core* core) { core->reset(); }
+    void plosive_core_set_params(plosive_core* core, const plosive_core_params* params) { core->setParameters(*params); }
+    int plosive_core_get_latency(const plosive_core* core) { return core->getLatencySamples(); }
+
+    void plosive_core_process(plosive_core* core, float* const* channels, int num_samples)
+    {
+        core->process(channels, num_samples);
+    }
+}
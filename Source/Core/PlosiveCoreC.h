@@ -0,0 +1,43 @@
+#ifndef PLOSIVE_CORE_C_H
+#define PLOSIVE_CORE_C_H
+
+/* C interface to plosive::Processor<float, N> (PlosiveCore.h), for hosts
+   that can't use C++ templates. The processor is allocated by
+   plosive_core_create; nothing allocates after that. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PLOSIVE_CORE_MAX_CHANNELS 8
+
+typedef struct plosive_core plosive_core;
+
+typedef struct plosive_core_params
+{
+    float sensitivity_db;     /* 0-24, default 6 */
+    float reduction_percent;  /* 0-100, default 70 */
+    float frequency_hz;       /* 100-400, default 200 */
+    float lookahead_ms;       /* 1-20, default 5; also the latency */
+} plosive_core_params;
+
+/* Fills params with the defaults */
+void plosive_core_default_params(plosive_core_params* params);
+
+/* 1 to PLOSIVE_CORE_MAX_CHANNELS channels; returns NULL otherwise or if out of memory */
+plosive_core* plosive_core_create(int num_channels);
+void plosive_core_destroy(plosive_core* core);
+
+void plosive_core_prepare(plosive_core* core, double sample_rate);
+void plosive_core_reset(plosive_core* core);
+void plosive_core_set_params(plosive_core* core, const plosive_core_params* params);
+int plosive_core_get_latency(const plosive_core* core);
+
+/* In place; channels holds one pointer per channel */
+void plosive_core_process(plosive_core* core, float* const* channels, int num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
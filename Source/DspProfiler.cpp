@@ -0,0 +1,207 @@
+#include "DspProfiler.h"
+#include <algorithm>
+#include <cmath>
+
+const char* DspProfiler::getStageName(int stage)
+{
+    static const char* const names[] = { "detection", "envelope_gain", "delay", "apply", "block" };
+    return names[stage];
+}
+
+double DspProfiler::getNanosecondsPerTick()
+{
+    static const double nanosecondsPerTick = []
+    {
+       #if JUCE_INTEL
+        // The TSC runs at a fixed rate on anything recent; measure it against
+        // the OS clock
+        auto start = juce::Time::getHighResolutionTicks();
+        auto startTicks = now();
+        auto minimum = juce::Time::getHighResolutionTicksPerSecond() / 200; // 5 ms
+
+        while (juce::Time::getHighResolutionTicks() - start < minimum)
+        {
+        }
+
+        auto elapsedNs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e9;
+        return elapsedNs / static_cast<double>(std::max<Ticks>(1, now() - startTicks));
+       #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+        Ticks frequency;
+        asm volatile ("mrs %0, cntfrq_el0" : "=r" (frequency));
+        return 1.0e9 / static_cast<double>(std::max<Ticks>(1, frequency));
+       #else
+        return 1.0e9 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+       #endif
+    }();
+
+    return nanosecondsPerTick;
+}
+
+void DspProfiler::prepare(double sampleRate)
+{
+    nsPerTick = getNanosecondsPerTick();
+    nsPerSample = 1.0e9 / sampleRate;
+    clear();
+    resetRequested.store(false);
+}
+
+int DspProfiler::getBucket(std::uint64_t ns)
+{
+    if (ns == 0)
+        return 0;
+
+    auto value = static_cast<std::uint32_t>(std::min<std::uint64_t>(ns, 0xffffffffu));
+    auto octave = juce::findHighestSetBit(value);
+
+    // The two bits below the leading one pick the quarter of the octave
+    auto quarter = octave >= 2 ? (value >> (octave - 2)) & 3u
+                               : (value << (2 - octave)) & 3u;
+
+    return std::min(NUM_BUCKETS - 1, octave * BUCKETS_PER_OCTAVE + static_cast<int>(quarter));
+}
+
+double DspProfiler::getBucketLowerNs(int bucket)
+{
+    auto octave = bucket / BUCKETS_PER_OCTAVE;
+    auto quarter = bucket % BUCKETS_PER_OCTAVE;
+    return std::ldexp(1.0 + quarter / static_cast<double>(BUCKETS_PER_OCTAVE), octave);
+}
+
+void DspProfiler::clear()
+{
+    for (auto& stage : stages)
+    {
+        stage.totalNs.store(0, std::memory_order_relaxed);
+        stage.minNs.store(0, std::memory_order_relaxed);
+        stage.maxNs.store(0, std::memory_order_relaxed);
+
+        for (auto& count : stage.histogram)
+            count.store(0, std::memory_order_relaxed);
+    }
+
+    audioNs.store(0, std::memory_order_relaxed);
+    blocks.store(0, std::memory_order_release);
+}
+
+void DspProfiler::record(const StageTicks& stageTicks, int numSamples)
+{
+    if (resetRequested.exchange(false, std::memory_order_acquire))
+        clear();
+
+    auto blockCount = blocks.load(std::memory_order_relaxed);
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto& stage = stages[static_cast<size_t>(s)];
+        auto ns = static_cast<std::uint64_t>(static_cast<double>(stageTicks[static_cast<size_t>(s)]) * nsPerTick);
+
+        // Single writer: plain load-and-store, no atomic read-modify-write
+        stage.totalNs.store(stage.totalNs.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+
+        if (blockCount == 0 || ns < stage.minNs.load(std::memory_order_relaxed))
+            stage.minNs.store(ns, std::memory_order_relaxed);
+
+        if (ns > stage.maxNs.load(std::memory_order_relaxed))
+            stage.maxNs.store(ns, std::memory_order_relaxed);
+
+        auto& count = stage.histogram[static_cast<size_t>(getBucket(ns))];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    auto duration = static_cast<std::uint64_t>(numSamples * nsPerSample);
+    audioNs.store(audioNs.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+    blocks.store(blockCount + 1, std::memory_order_release);
+}
+
+DspProfiler::Stats DspProfiler::getStats(int stage) const
+{
+    auto& counters = stages[static_cast<size_t>(stage)];
+
+    Stats stats;
+    stats.blocks = blocks.load(std::memory_order_acquire);
+
+    if (stats.blocks == 0)
+        return stats;
+
+    stats.minNs = static_cast<double>(counters.minNs.load(std::memory_order_relaxed));
+    stats.maxNs = static_cast<double>(counters.maxNs.load(std::memory_order_relaxed));
+    stats.meanNs = static_cast<double>(counters.totalNs.load(std::memory_order_relaxed)) / static_cast<double>(stats.blocks);
+
+    std::uint64_t histogramTotal = 0;
+    for (auto& count : counters.histogram)
+        histogramTotal += count.load(std::memory_order_relaxed);
+
+    // First bucket whose cumulative count reaches 99%
+    auto target = (histogramTotal * 99 + 99) / 100;
+    std::uint64_t cumulative = 0;
+
+    for (int b = 0; b < NUM_BUCKETS; ++b)
+    {
+        cumulative += counters.histogram[static_cast<size_t>(b)].load(std::memory_order_relaxed);
+
+        if (cumulative >= target)
+        {
+            stats.p99Ns = std::min(stats.maxNs, getBucketLowerNs(b + 1));
+            break;
+        }
+    }
+
+    return stats;
+}
+
+double DspProfiler::getLoad(LoadReading& previous) const
+{
+    LoadReading current;
+    current.processNs = stages[block].totalNs.load(std::memory_order_relaxed);
+    current.audioNs = audioNs.load(std::memory_order_relaxed);
+
+    // A reset in between makes the counters go backwards; start over from it
+    if (current.audioNs < previous.audioNs || current.processNs < previous.processNs)
+        previous = {};
+
+    auto processed = current.processNs - previous.processNs;
+    auto audio = current.audioNs - previous.audioNs;
+    previous = current;
+
+    return audio > 0 ? static_cast<double>(processed) / static_cast<double>(audio) : 0.0;
+}
+
+juce::String DspProfiler::toJson() const
+{
+    juce::String json;
+    json << "{\n"
+         << "  \"blocks\": " << juce::String(static_cast<juce::int64>(blocks.load())) << ",\n"
+         << "  \"audio_seconds\": " << juce::String(static_cast<double>(audioNs.load()) * 1.0e-9, 3) << ",\n"
+         << "  \"stages\": {";
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto stats = getStats(s);
+
+        json << (s == 0 ? "\n" : ",\n")
+             << "    \"" << getStageName(s) << "\": {"
+             << " \"min_ns\": " << juce::String(stats.minNs, 0)
+             << ", \"mean_ns\": " << juce::String(stats.meanNs, 1)
+             << ", \"p99_ns\": " << juce::String(stats.p99Ns, 0)
+             << ", \"max_ns\": " << juce::String(stats.maxNs, 0)
+             << ", \"histogram\": [";
+
+        // [lower edge in ns, blocks] for each non-empty bucket
+        bool first = true;
+        for (int b = 0; b < NUM_BUCKETS; ++b)
+        {
+            auto count = stages[static_cast<size_t>(s)].histogram[static_cast<size_t>(b)].load(std::memory_order_relaxed);
+
+            if (count == 0)
+                continue;
+
+            json << (first ? "" : ", ") << "[" << juce::String(getBucketLowerNs(b), 0) << ", " << juce::String(count) << "]";
+            first = false;
+        }
+
+        json << "] }";
+    }
+
+    json << "\n  }\n}\n";
+    return json;
+}
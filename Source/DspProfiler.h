@@ -0,0 +1,120 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+// Per-stage processBlock timing, cheap enough to leave on in release builds.
+//
+// The audio thread reads the CPU timestamp counter around each stage (a few
+// tens of cycles per read), sums the stage times over the block, and records
+// one sample per stage per block: min, max, running total and a log-scale
+// histogram. It is the only writer, so the counters are relaxed atomic
+// loads and stores with no read-modify-write. The editor and the dump read
+// them from any thread and may see a block half-recorded, which is fine for
+// statistics.
+class DspProfiler
+{
+public:
+    enum Stage
+    {
+        detection,       // mixing the detection input and the spectral gate
+        envelopeAndGain, // the detector's filter, envelopes and gain curve (one fused pass)
+        delay,           // look-ahead delay
+        apply,           // broadband, split-band or spectral-repair gain
+        block,           // all of processBlock, including metering and events
+        numStages
+    };
+
+    static const char* getStageName(int stage);
+
+    // Histogram buckets: four per octave of nanoseconds, from 1 ns up to
+    // 2^27 ns (134 ms); longer blocks land in the last bucket
+    static constexpr int BUCKETS_PER_OCTAVE = 4;
+    static constexpr int NUM_OCTAVES = 27;
+    static constexpr int NUM_BUCKETS = BUCKETS_PER_OCTAVE * NUM_OCTAVES;
+
+    using Ticks = std::uint64_t;
+    using StageTicks = std::array<Ticks, numStages>;
+
+    static Ticks now()
+    {
+       #if JUCE_INTEL
+        return __rdtsc();
+       #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+        Ticks ticks;
+        asm volatile ("mrs %0, cntvct_el0" : "=r" (ticks));
+        return ticks;
+       #else
+        return static_cast<Ticks>(juce::Time::getHighResolutionTicks());
+       #endif
+    }
+
+    // Measured once per process (a few ms of busy-waiting on x86); call
+    // before the audio thread needs it, e.g. from prepareToPlay
+    static double getNanosecondsPerTick();
+
+    // Sets the rate used for CPU load and clears the statistics
+    void prepare(double sampleRate);
+
+    // Audio thread: one call per processed block
+    void record(const StageTicks& stageTicks, int numSamples);
+
+    // Any thread; takes effect at the next recorded block
+    void reset() { resetRequested.store(true); }
+
+    struct Stats
+    {
+        std::uint64_t blocks = 0;
+        double minNs = 0.0;
+        double meanNs = 0.0;
+        double p99Ns = 0.0;    // upper edge of the histogram bucket holding the 99th percentile
+        double maxNs = 0.0;
+    };
+
+    Stats getStats(int stage) const;
+
+    // Share of realtime spent in processBlock since the previous call with the
+    // same reading (1.0 = a whole core). Returns 0 when nothing was processed.
+    struct LoadReading
+    {
+        std::uint64_t processNs = 0;
+        std::uint64_t audioNs = 0;
+    };
+
+    double getLoad(LoadReading& previous) const;
+
+    // Every stage's statistics and non-empty histogram buckets as JSON
+    juce::String toJson() const;
+
+    static double getBucketLowerNs(int bucket);
+
+private:
+    struct StageCounters
+    {
+        std::atomic<std::uint64_t> totalNs{0};
+        std::atomic<std::uint64_t> minNs{0};
+        std::atomic<std::uint64_t> maxNs{0};
+        std::array<std::atomic<std::uint32_t>, NUM_BUCKETS> histogram{};
+    };
+
+    static int getBucket(std::uint64_t ns);
+    void clear();
+
+    std::array<StageCounters, numStages> stages;
+    std::atomic<std::uint64_t> blocks{0};
+    std::atomic<std::uint64_t> audioNs{0};   // duration of the audio processed
+    std::atomic<bool> resetRequested{false};
+
+    double nsPerTick = 1.0;
+    double nsPerSample = 1.0e9 / 44100.0;
+};
@@ -0,0 +1,225 @@
+#include "PlosiveSessionEngine.h"
+#include "../LookaheadDelayLine.h"
+#include "../PlosiveDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+struct PlosiveSessionEngine::Impl
+{
+    struct Track
+    {
+        int firstChannel = 0;
+        int numChannels = 1;
+        int group = 0;                 // detector the track runs in
+        int unit = 0;                  // lane within that detector
+        float mixScale = 1.0f;         // 1 / numChannels, as the processor's linked grouping
+        int lookaheadSamples = 0;
+        bool settingsChanged = true;
+        TrackSettings settings;
+        LookaheadDelayLine delayLine;
+    };
+
+    struct Group
+    {
+        int firstTrack = 0;
+        int numTracks = 0;
+        PlosiveDetector detector;
+    };
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int maxLookaheadSamples = 0;
+    int totalChannels = 0;
+    PlosiveDetector::Mode mode = PlosiveDetector::Mode::logDomain;
+
+    std::vector<Track> tracks;
+    std::vector<Group> groups;
+
+    int lookaheadMsToSamples(float ms) const
+    {
+        auto samples = static_cast<int>(sampleRate * static_cast<double>(ms) / 1000.0);
+        return std::min(samples, maxLookaheadSamples);
+    }
+
+    void applySettings(Track& track)
+    {
+        auto& settings = track.settings;
+        auto& detector = groups[static_cast<size_t>(track.group)].detector;
+
+        // Same detection cutoff and Q as PlosiveRemoverProcessor::updateFilters
+        detector.setUnitLowPass(track.unit, settings.frequencyHz * 1.5f, 0.5f);
+        detector.setUnitSettings(track.unit, settings.sensitivityDb, settings.reductionPercent / 100.0f);
+        track.lookaheadSamples = lookaheadMsToSamples(settings.lookaheadMs);
+        track.settingsChanged = false;
+    }
+
+    // Averages a track's channels into its lane of the detector input, with
+    // the same operations in the same order as the processor's linked mix
+    void mixDetectionInput(const Track& track, float* const* channels, int startSample, int numSamples)
+    {
+        auto& detector = groups[static_cast<size_t>(track.group)].detector;
+        auto numUnits = detector.getNumUnits();
+        auto* dest = detector.getInputBuffer() + track.unit;
+        auto* const* trackChannels = channels + track.firstChannel;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float sum = trackChannels[0][startSample + i];
+
+            for (int channel = 1; channel < track.numChannels; ++channel)
+                sum += trackChannels[channel][startSample + i];
+
+            if (track.numChannels > 1)
+                sum *= track.mixScale;
+
+            dest[i * numUnits] = sum;
+        }
+    }
+};
+
+PlosiveSessionEngine::PlosiveSessionEngine()
+    : impl(std::make_unique<Impl>())
+{
+}
+
+PlosiveSessionEngine::~PlosiveSessionEngine() = default;
+
+void PlosiveSessionEngine::prepare(double sampleRate, int maxBlockSize, const int* channelsPerTrack, int numTracks)
+{
+    impl->sampleRate = sampleRate;
+    impl->maxBlockSize = std::max(1, maxBlockSize);
+    impl->maxLookaheadSamples = static_cast<int>(std::ceil(sampleRate * MAX_LOOKAHEAD_MS / 1000.0));
+
+    numTracks = std::max(0, numTracks);
+    auto numGroups = (numTracks + PlosiveDetector::MAX_UNITS - 1) / PlosiveDetector::MAX_UNITS;
+
+    // Settings survive a re-prepare for tracks that still exist
+    impl->tracks.resize(static_cast<size_t>(numTracks));
+    impl->groups = std::vector<Impl::Group>(static_cast<size_t>(numGroups));
+    impl->totalChannels = 0;
+
+    for (int t = 0; t < numTracks; ++t)
+    {
+        auto& track = impl->tracks[static_cast<size_t>(t)];
+        track.numChannels = juce::jlimit(1, MAX_CHANNELS_PER_TRACK, channelsPerTrack[t]);
+        track.firstChannel = impl->totalChannels;
+        track.group = t / PlosiveDetector::MAX_UNITS;
+        track.unit = t % PlosiveDetector::MAX_UNITS;
+        track.mixScale = 1.0f / static_cast<float>(track.numChannels);
+        track.delayLine.prepare(track.numChannels, impl->maxLookaheadSamples, impl->maxBlockSize);
+        track.settingsChanged = true;
+
+        impl->totalChannels += track.numChannels;
+    }
+
+    for (int g = 0; g < numGroups; ++g)
+    {
+        auto& group = impl->groups[static_cast<size_t>(g)];
+        group.firstTrack = g * PlosiveDetector::MAX_UNITS;
+        group.numTracks = std::min(PlosiveDetector::MAX_UNITS, numTracks - group.firstTrack);
+        group.detector.prepare(sampleRate, impl->maxBlockSize);
+        group.detector.setNumUnits(group.numTracks);
+    }
+
+    for (auto& track : impl->tracks)
+        impl->applySettings(track);
+}
+
+void PlosiveSessionEngine::release()
+{
+    impl->tracks.clear();
+    impl->groups.clear();
+    impl->totalChannels = 0;
+    impl->maxBlockSize = 0;
+}
+
+void PlosiveSessionEngine::reset()
+{
+    for (auto& track : impl->tracks)
+        track.delayLine.reset();
+
+    for (auto& group : impl->groups)
+        group.detector.reset();
+}
+
+int PlosiveSessionEngine::getNumTracks() const
+{
+    return static_cast<int>(impl->tracks.size());
+}
+
+int PlosiveSessionEngine::getTotalNumChannels() const
+{
+    return impl->totalChannels;
+}
+
+int PlosiveSessionEngine::getFirstChannel(int track) const
+{
+    return impl->tracks[static_cast<size_t>(track)].firstChannel;
+}
+
+void PlosiveSessionEngine::setTrackSettings(int track, const TrackSettings& settings)
+{
+    auto& t = impl->tracks[static_cast<size_t>(track)];
+    t.settings = settings;
+    t.settings.lookaheadMs = juce::jlimit(MIN_LOOKAHEAD_MS, MAX_LOOKAHEAD_MS, settings.lookaheadMs);
+    t.settingsChanged = true;
+}
+
+void PlosiveSessionEngine::setLinearDetector(bool shouldUseLinearDetector)
+{
+    impl->mode = shouldUseLinearDetector ? PlosiveDetector::Mode::linearDomain
+                                         : PlosiveDetector::Mode::logDomain;
+}
+
+int PlosiveSessionEngine::getLatencySamples(int track) const
+{
+    auto& t = impl->tracks[static_cast<size_t>(track)];
+    return t.settingsChanged ? impl->lookaheadMsToSamples(t.settings.lookaheadMs) : t.lookaheadSamples;
+}
+
+void PlosiveSessionEngine::process(float* const* channels, int numSamples)
+{
+    auto maxChunk = impl->maxBlockSize;
+
+    if (maxChunk == 0)
+        return;
+
+    for (auto& track : impl->tracks)
+        if (track.settingsChanged)
+            impl->applySettings(track);
+
+    for (int start = 0; start < numSamples; start += maxChunk)
+    {
+        auto chunk = std::min(maxChunk, numSamples - start);
+
+        for (auto& group : impl->groups)
+        {
+            auto firstTrack = static_cast<size_t>(group.firstTrack);
+            auto endTrack = firstTrack + static_cast<size_t>(group.numTracks);
+
+            for (auto t = firstTrack; t < endTrack; ++t)
+                impl->mixDetectionInput(impl->tracks[t], channels, start, chunk);
+
+            // One pass over every lane of the group
+            group.detector.process(chunk, impl->mode);
+
+            for (auto t = firstTrack; t < endTrack; ++t)
+            {
+                auto& track = impl->tracks[t];
+
+                // Refers to the host's channel pointers; no allocation up to 32 channels
+                juce::AudioBuffer<float> view(channels + track.firstChannel, track.numChannels, start, chunk);
+                track.delayLine.process(view, 0, chunk, track.numChannels, track.lookaheadSamples);
+
+                if (group.detector.hasUnityGain(track.unit))
+                    continue;
+
+                const auto* gains = group.detector.getGains(track.unit);
+
+                for (int channel = 0; channel < track.numChannels; ++channel)
+                    juce::FloatVectorOperations::multiply(view.getWritePointer(channel), gains, chunk);
+            }
+        }
+    }
+}
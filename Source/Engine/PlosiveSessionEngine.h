@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+
+// Runs many independent plosive removers ("tracks") as one engine, for hosts
+// that put a remover on every track of a session. Each track is the chain
+// PlosiveRemoverProcessor runs with linked detection and split band, spectral
+// detection and repair off: its channels are averaged for detection and all
+// of them are ducked by the same gain after the look-ahead delay.
+//
+// Tracks are packed PlosiveDetector::MAX_UNITS (16) to a detector, one track
+// per unit, so the per-sample detector loops are unit-innermost loops over
+// tracks that the compiler may vectorize, instead of running once per track. With
+// the same settings and blocks, a track's output is bit-identical to a
+// PlosiveRemoverProcessor's; PlosiveBenchmark --session checks this.
+//
+// This header doesn't include JUCE, so hosts can link the PlosiveEngine
+// library without JUCE on their include path.
+class PlosiveSessionEngine
+{
+public:
+    static constexpr int MAX_CHANNELS_PER_TRACK = 16;
+    static constexpr float MIN_LOOKAHEAD_MS = 1.0f;
+    static constexpr float MAX_LOOKAHEAD_MS = 20.0f;
+
+    // The plugin's parameters, with the same ranges and defaults
+    struct TrackSettings
+    {
+        float sensitivityDb = 6.0f;   // 0-24
+        float reductionPercent = 70.0f;
+        float frequencyHz = 200.0f;   // 100-400
+        float lookaheadMs = 5.0f;     // 1-20
+    };
+
+    PlosiveSessionEngine();
+    ~PlosiveSessionEngine();
+
+    // Allocates for numTracks tracks with the given channel counts (1-16 each)
+    // and resets them. Not realtime-safe.
+    void prepare(double sampleRate, int maxBlockSize, const int* channelsPerTrack, int numTracks);
+    void release();
+    void reset();
+
+    int getNumTracks() const;
+    int getTotalNumChannels() const;
+
+    // Index of a track's first channel in the array passed to process()
+    int getFirstChannel(int track) const;
+
+    // Call from the processing thread; applies from the next process() call.
+    // A cutoff change takes effect at once rather than gliding as it does in
+    // the plugin.
+    void setTrackSettings(int track, const TrackSettings& settings);
+
+    // See PlosiveDetector::Mode; the log-domain detector is the default
+    void setLinearDetector(bool shouldUseLinearDetector);
+
+    // Each track's latency follows its own look-ahead
+    int getLatencySamples(int track) const;
+
+    // Processes every track in place. channels holds getTotalNumChannels()
+    // pointers, track by track. Any numSamples is fine; blocks longer than
+    // maxBlockSize are split up. Realtime-safe.
+    void process(float* const* channels, int numSamples);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// log2 approximation for the detector hot loop. The exponent comes straight from
+// the float bits and the mantissa (in [1, 2)) goes through a 4th-order
+// least-squares polynomial. Max error is ~2e-4, i.e. ~0.001 dB once scaled by
+// 20*log10(2). Branch-free, so loops calling it auto-vectorize.
+// Only valid for positive, finite, normal inputs.
+inline float fastLog2(float x) noexcept
+{
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+
+    auto exponent = static_cast<float>(static_cast<int32_t>((bits >> 23) & 0xffu) - 127);
+
+    bits = (bits & 0x007fffffu) | 0x3f800000u;
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    float t = mantissa - 1.0f;
+    return exponent + t * (1.4385468f + t * (-0.67808149f + t * (0.32363037f + t * -0.084285093f)));
+}
+
+// 20 * log10(x) via fastLog2
+inline float fastGainToDecibels(float x) noexcept
+{
+    return 6.0205999f * fastLog2(x);
+}
@@ -0,0 +1,127 @@
+#include "GainEnvelopeCache.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr juce::uint64 FNV_PRIME = 1099511628211ull;
+    constexpr float UNTRIGGERED = -1.0f;
+
+    // FNV-1a over 32-bit words rather than bytes: a quarter of the
+    // multiplies, still well spread for audio
+    juce::uint64 hashWords(juce::uint64 hash, const float* values, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            juce::uint32 word;
+            std::memcpy(&word, values + i, sizeof(word));
+            hash = (hash ^ word) * FNV_PRIME;
+        }
+
+        return hash;
+    }
+
+    bool isUntriggered(const float* value)
+    {
+        return std::memcmp(value, &UNTRIGGERED, sizeof(float)) == 0;
+    }
+
+    // Bytes an entry takes beyond the map node itself
+    size_t entryBytes(size_t numRuns, size_t numTriggered)
+    {
+        return sizeof(PlosiveDetector::DetectionState) + numRuns * sizeof(juce::uint32) + numTriggered * sizeof(float) + 64;
+    }
+}
+
+GainEnvelopeCache::Key GainEnvelopeCache::keyFor(Key previous, const float* settings, int numSettings,
+                                                 const float* input, int numSamples, int numUnits)
+{
+    float shape[] = { static_cast<float>(numSamples), static_cast<float>(numUnits) };
+
+    auto hash = (CHAIN_START ^ previous) * FNV_PRIME;
+    hash = hashWords(hash, shape, 2);
+    hash = hashWords(hash, settings, static_cast<size_t>(numSettings));
+    return hashWords(hash, input, static_cast<size_t>(numSamples * numUnits));
+}
+
+bool GainEnvelopeCache::find(Key key, int numSamples, int numUnits, float* excess,
+                             PlosiveDetector::DetectionState& state)
+{
+    auto it = entries.find(key);
+
+    if (it == entries.end() || it->second.numSamples != numSamples || it->second.numUnits != numUnits)
+    {
+        ++misses;
+        return false;
+    }
+
+    auto& entry = it->second;
+    const auto* triggered = entry.triggeredValues.data();
+
+    for (size_t run = 0; run < entry.runLengths.size(); ++run)
+    {
+        auto length = entry.runLengths[run];
+
+        if (run % 2 == 0)
+        {
+            excess = std::fill_n(excess, length, UNTRIGGERED);
+        }
+        else
+        {
+            excess = std::copy_n(triggered, length, excess);
+            triggered += length;
+        }
+    }
+
+    state = entry.state;
+    ++hits;
+    return true;
+}
+
+void GainEnvelopeCache::store(Key key, const float* excess, int numSamples, int numUnits,
+                              const PlosiveDetector::DetectionState& state)
+{
+    Entry entry;
+    entry.numSamples = numSamples;
+    entry.numUnits = numUnits;
+    entry.state = state;
+
+    // Untriggered samples are all exactly -1 and code to one length per run.
+    // Triggered samples rarely repeat, so a run per value would double them.
+    auto total = static_cast<size_t>(numSamples * numUnits);
+
+    for (size_t i = 0; i < total;)
+    {
+        auto end = i;
+        while (end < total && isUntriggered(excess + end))
+            ++end;
+
+        entry.runLengths.push_back(static_cast<juce::uint32>(end - i));
+        i = end;
+
+        while (end < total && !isUntriggered(excess + end))
+            ++end;
+
+        if (end > i)
+        {
+            entry.runLengths.push_back(static_cast<juce::uint32>(end - i));
+            entry.triggeredValues.insert(entry.triggeredValues.end(), excess + i, excess + end);
+            i = end;
+        }
+    }
+
+    auto bytes = entryBytes(entry.runLengths.size(), entry.triggeredValues.size());
+
+    if (memoryUsage + bytes > memoryLimit)
+        clear();
+
+    auto inserted = entries.insert_or_assign(key, std::move(entry));
+    if (inserted.second)
+        memoryUsage += bytes;
+}
+
+void GainEnvelopeCache::clear()
+{
+    entries.clear();
+    memoryUsage = 0;
+}
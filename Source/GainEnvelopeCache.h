@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "PlosiveDetector.h"
+#include <unordered_map>
+#include <vector>
+
+// Detection results of offline renders, so a re-bounce of unchanged audio
+// skips detection and only re-runs the gain smoother.
+//
+// An entry holds one processed block's per-sample excess over the trigger
+// threshold (getExcessDb's layout, -1 where nothing triggered) and the
+// detector state at the end of the block. Untriggered runs are stored as a
+// length; triggered stretches vary every sample, so they are stored as-is. The excess doesn't
+// depend on the reduction amount, so changing reduction between bounces still
+// hits; the smoother replays it at the new amount (PlosiveDetector::replayGains).
+//
+// Keys chain: each block's key hashes the previous block's key, the detection
+// settings and the block's detection input, so a hit means the whole history
+// up to that block matches. Silence and untriggered stretches code to a
+// single run, so most blocks take a few dozen bytes.
+//
+// Storing allocates, so the processor only uses the cache while rendering
+// offline. Once over the memory limit, the cache is emptied and starts over.
+class GainEnvelopeCache
+{
+public:
+    static constexpr size_t DEFAULT_MEMORY_LIMIT = 256 * 1024 * 1024;
+
+    using Key = juce::uint64;
+    static constexpr Key CHAIN_START = 14695981039346656037ull;  // FNV-1a offset basis
+
+    // Key of a block: the previous key, detection settings and input
+    // (numSamples * numUnits interleaved values)
+    static Key keyFor(Key previous, const float* settings, int numSettings,
+                      const float* input, int numSamples, int numUnits);
+
+    // On a hit, writes the block's excess into excess (numSamples * numUnits)
+    // and the detector state after it into state
+    bool find(Key key, int numSamples, int numUnits, float* excess, PlosiveDetector::DetectionState& state);
+
+    void store(Key key, const float* excess, int numSamples, int numUnits,
+               const PlosiveDetector::DetectionState& state);
+
+    void clear();
+    void setMemoryLimit(size_t bytes) { memoryLimit = bytes; }
+    size_t getMemoryUsage() const { return memoryUsage; }
+
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+    void resetCounters() { hits = misses = 0; }
+
+private:
+    struct Entry
+    {
+        int numSamples = 0;
+        int numUnits = 0;
+
+        // Alternating untriggered and triggered run lengths, starting with an
+        // untriggered run that may be empty; the triggered values back to back
+        std::vector<juce::uint32> runLengths;
+        std::vector<float> triggeredValues;
+        PlosiveDetector::DetectionState state;
+    };
+
+    std::unordered_map<Key, Entry> entries;
+    size_t memoryLimit = DEFAULT_MEMORY_LIMIT;
+    size_t memoryUsage = 0;
+    int hits = 0, misses = 0;
+};
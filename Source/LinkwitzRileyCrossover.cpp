@@ -0,0 +1,106 @@
+#include "LinkwitzRileyCrossover.h"
+#include <cmath>
+
+template <typename Sample>
+void BasicLinkwitzRileyCrossover<Sample>::prepare(int numChannels)
+{
+    auto numGroups = (numChannels + numLanes - 1) / numLanes;
+    groups.resize(static_cast<size_t>(numGroups));
+    reset();
+}
+
+template <typename Sample>
+void BasicLinkwitzRileyCrossover<Sample>::reset()
+{
+    for (auto& g : groups)
+        g = GroupState{};
+}
+
+template <typename Sample>
+void BasicLinkwitzRileyCrossover<Sample>::setCutoff(float cutoffHz, double sampleRate)
+{
+    if (cutoffHz == cachedCutoff && sampleRate == cachedSampleRate)
+        return;
+
+    auto w0 = Sample(2) * juce::MathConstants<Sample>::pi * static_cast<Sample>(cutoffHz) / static_cast<Sample>(sampleRate);
+    setCoefficients(std::cos(w0), std::sin(w0));
+
+    cachedCutoff = cutoffHz;
+    cachedSampleRate = sampleRate;
+}
+
+template <typename Sample>
+void BasicLinkwitzRileyCrossover<Sample>::setCoefficients(Sample cosw0, Sample sinw0)
+{
+    // Any direct update invalidates the cache; setCutoff() re-validates it
+    cachedCutoff = -1.0f;
+
+    // Butterworth sections (Q = 1/sqrt(2)); squared they give the LR4 response
+    Sample alpha = sinw0 / (Sample(2) * static_cast<Sample>(0.70710678118654752));
+    Sample a0 = Sample(1) + alpha;
+
+    auto a1 = Vec::expand((Sample(-2) * cosw0) / a0);
+    auto a2 = Vec::expand((Sample(1) - alpha) / a0);
+
+    lowPass.b0 = Vec::expand(((Sample(1) - cosw0) / Sample(2)) / a0);
+    lowPass.b1 = Vec::expand((Sample(1) - cosw0) / a0);
+    lowPass.b2 = lowPass.b0;
+    lowPass.a1 = a1;
+    lowPass.a2 = a2;
+
+    highPass.b0 = Vec::expand(((Sample(1) + cosw0) / Sample(2)) / a0);
+    highPass.b1 = Vec::expand((-(Sample(1) + cosw0)) / a0);
+    highPass.b2 = highPass.b0;
+    highPass.a1 = a1;
+    highPass.a2 = a2;
+}
+
+template <typename Sample>
+void BasicLinkwitzRileyCrossover<Sample>::process(juce::AudioBuffer<Sample>& buffer, int startSample, int numSamples,
+                                                  int numChannels, const float* const* lowGains)
+{
+    alignas(32) Sample frame[numLanes];
+    alignas(32) Sample gainFrame[numLanes];
+
+    for (size_t group = 0; group < groups.size(); ++group)
+    {
+        auto& state = groups[group];
+        auto firstChannel = static_cast<int>(group) * numLanes;
+        auto lanesUsed = std::min(numLanes, numChannels - firstChannel);
+
+        Sample* channels[numLanes] = {};
+        const float* gains[numLanes] = {};
+        for (int lane = 0; lane < lanesUsed; ++lane)
+        {
+            channels[lane] = buffer.getWritePointer(firstChannel + lane, startSample);
+            gains[lane] = lowGains[firstChannel + lane];
+        }
+
+        // Work on local copies so the state stays in registers for the block
+        auto s = state;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                frame[lane] = lane < lanesUsed ? channels[lane][i] : Sample(0);
+                gainFrame[lane] = lane < lanesUsed ? static_cast<Sample>(gains[lane][i]) : Sample(0);
+            }
+
+            auto x = Vec::fromRawArray(frame);
+
+            auto low = tick(lowPass, tick(lowPass, x, s.lp1s1, s.lp1s2), s.lp2s1, s.lp2s2);
+            auto high = tick(highPass, tick(highPass, x, s.hp1s1, s.hp1s2), s.hp2s1, s.hp2s2);
+
+            (low * Vec::fromRawArray(gainFrame) + high).copyToRawArray(frame);
+
+            for (int lane = 0; lane < lanesUsed; ++lane)
+                channels[lane][i] = frame[lane];
+        }
+
+        state = s;
+    }
+}
+
+template class BasicLinkwitzRileyCrossover<float>;
+template class BasicLinkwitzRileyCrossover<double>;
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <algorithm>
+#include <vector>
+
+// 4th-order Linkwitz-Riley crossover (two cascaded Butterworth biquads per band).
+// The low and high outputs are in phase and sum to an allpass, so scaling only
+// the low band leaves the rest of the signal untouched.
+//
+// Channels are packed into the lanes of a SIMDRegister, so one pass filters up
+// to Vec::size() channels (stereo fits in a single register). Instantiated for
+// float and double samples; coefficients and state use the sample type.
+template <typename Sample>
+class BasicLinkwitzRileyCrossover
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<Sample>;
+    static constexpr int numLanes = static_cast<int>(Vec::SIMDNumElements);
+
+    // Allocates filter state; call from prepareToPlay
+    void prepare(int numChannels);
+    void reset();
+
+    // One cos/sin pair for all four stages and all channels. Does nothing
+    // when the cutoff and sample rate match the last call.
+    void setCutoff(float cutoffHz, double sampleRate);
+
+    // Same, from a precomputed cos/sin of w0 (used while the cutoff is ramping)
+    void setCoefficients(Sample cosw0, Sample sinw0);
+
+    // Filters numChannels channels in place: out = low * lowGains[channel][i] + high.
+    // Channels may share a gain curve (linked detection) or each have their own.
+    void process(juce::AudioBuffer<Sample>& buffer, int startSample, int numSamples,
+                 int numChannels, const float* const* lowGains);
+
+private:
+    struct Coefficients
+    {
+        Vec b0, b1, b2, a1, a2;
+    };
+
+    // Transposed direct form II state for one group of channels
+    struct GroupState
+    {
+        Vec lp1s1, lp1s2, lp2s1, lp2s2;
+        Vec hp1s1, hp1s2, hp2s1, hp2s2;
+    };
+
+    static Vec tick(const Coefficients& c, Vec x, Vec& s1, Vec& s2)
+    {
+        Vec y = c.b0 * x + s1;
+        s1 = c.b1 * x - c.a1 * y + s2;
+        s2 = c.b2 * x - c.a2 * y;
+        return y;
+    }
+
+    Coefficients lowPass, highPass;
+    float cachedCutoff = -1.0f;
+    double cachedSampleRate = 0.0;
+    std::vector<GroupState> groups;
+};
+
+using LinkwitzRileyCrossover = BasicLinkwitzRileyCrossover<float>;
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <vector>
+
+// Multichannel look-ahead delay with a power-of-two ring per channel, so
+// positions wrap with a mask. Audio moves in at most two contiguous copies
+// per channel per block instead of one indexed access per sample.
+template <typename Sample>
+class BasicLookaheadDelayLine
+{
+public:
+    // Allocates; call from prepareToPlay. The ring holds the longest delay plus
+    // one block, so a block can be written before its delayed output is read.
+    void prepare(int numChannels, int maxDelaySamples, int maxBlockSize)
+    {
+        size = juce::nextPowerOfTwo(maxDelaySamples + maxBlockSize);
+        mask = size - 1;
+        channels = numChannels;
+        ring.assign(static_cast<size_t>(size * numChannels), Sample(0));
+        writePos = 0;
+    }
+
+    void reset()
+    {
+        std::fill(ring.begin(), ring.end(), Sample(0));
+        writePos = 0;
+    }
+
+    void release()
+    {
+        ring.clear();
+        ring.shrink_to_fit();
+        channels = 0;
+    }
+
+    int getMaxBlockSize(int delaySamples) const { return size - delaySamples; }
+
+    // Replaces each channel's samples with the ones from delaySamples earlier.
+    // numSamples must not exceed getMaxBlockSize(delaySamples).
+    void process(juce::AudioBuffer<Sample>& buffer, int startSample, int numSamples, int numChannels, int delaySamples)
+    {
+        auto readPos = (writePos - delaySamples) & mask;
+
+        for (int channel = 0; channel < std::min(numChannels, channels); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel, startSample);
+            auto* line = ring.data() + static_cast<size_t>(channel * size);
+
+            copyIn(line, writePos, data, numSamples);
+            copyOut(data, line, readPos, numSamples);
+        }
+
+        writePos = (writePos + numSamples) & mask;
+    }
+
+private:
+    void copyIn(Sample* line, int pos, const Sample* src, int numSamples) const
+    {
+        auto first = std::min(numSamples, size - pos);
+        juce::FloatVectorOperations::copy(line + pos, src, first);
+        juce::FloatVectorOperations::copy(line, src + first, numSamples - first);
+    }
+
+    void copyOut(Sample* dest, const Sample* line, int pos, int numSamples) const
+    {
+        auto first = std::min(numSamples, size - pos);
+        juce::FloatVectorOperations::copy(dest, line + pos, first);
+        juce::FloatVectorOperations::copy(dest + first, line, numSamples - first);
+    }
+
+    std::vector<Sample> ring;
+    int size = 0;
+    int mask = 0;
+    int channels = 0;
+    int writePos = 0;
+};
+
+using LookaheadDelayLine = BasicLookaheadDelayLine<float>;
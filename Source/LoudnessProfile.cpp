@@ -0,0 +1,133 @@
+#include "LoudnessProfile.h"
+#include "Core/PlosiveCore.h"
+#include <algorithm>
+#include <cmath>
+
+void LoudnessProfile::prepare(double sampleRate, int newNumUnits, PlosiveDetector::Filter newFilter,
+                              float lowPassCutoffHz, juce::int64 expectedLength)
+{
+    numUnits = juce::jlimit(1, PlosiveDetector::MAX_UNITS, newNumUnits);
+    hopSize = std::max(1, static_cast<int>(sampleRate * HOP_SECONDS));
+    finished = false;
+    filter = newFilter;
+
+    // The same design as PlosiveDetector::setLowPass
+    float w0 = 2.0f * plosive::pi<float> * lowPassCutoffHz / static_cast<float>(sampleRate);
+    auto cosw0 = std::cos(w0);
+    auto sinw0 = std::sin(w0);
+
+    auto coefficients = plosive::LowPassCoefficients<float>::fromTrig(cosw0, sinw0, 0.5f);
+    b0 = coefficients.b0;
+    b1 = coefficients.b1;
+    b2 = coefficients.b2;
+    a1 = coefficients.a1;
+    a2 = coefficients.a2;
+    svf = PlosiveDetector::designSvf(cosw0, sinw0, 0.5f);
+
+    std::fill(std::begin(z1), std::end(z1), 0.0f);
+    std::fill(std::begin(z2), std::end(z2), 0.0f);
+    std::fill(std::begin(hopSum), std::end(hopSum), 0.0f);
+    hopFill = 0;
+
+    levels.clear();
+    if (expectedLength > 0)
+        levels.reserve(static_cast<size_t>((expectedLength / hopSize + 1) * numUnits));
+}
+
+void LoudnessProfile::addBlock(const float* input, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto* x = input + i * numUnits;
+
+        // The detector's low-pass recursions: PlosiveDetector::lowPassSvf, or
+        // the biquad as in plosive::Detector
+        if (filter == PlosiveDetector::Filter::svf)
+        {
+            for (int u = 0; u < numUnits; ++u)
+            {
+                float v3 = x[u] - z2[u];
+                float v1 = svf.a1 * z1[u] + svf.a2 * v3;
+                float v2 = z2[u] + svf.a2 * z1[u] + svf.a3 * v3;
+                float lowFreq = svf.m0 * x[u] + svf.m1 * v1 + svf.m2 * v2;
+                z1[u] = 2.0f * v1 - z1[u];
+                z2[u] = 2.0f * v2 - z2[u];
+                hopSum[u] += std::abs(lowFreq);
+            }
+        }
+        else
+        {
+            for (int u = 0; u < numUnits; ++u)
+            {
+                float lowFreq = b0 * x[u] + b1 * z1[u] + b2 * z2[u] - a1 * z1[u] - a2 * z2[u];
+                z2[u] = z1[u];
+                z1[u] = lowFreq;
+                hopSum[u] += std::abs(lowFreq);
+            }
+        }
+
+        if (++hopFill == hopSize)
+            endHop();
+    }
+}
+
+void LoudnessProfile::endHop()
+{
+    auto scale = 1.0f / static_cast<float>(hopFill);
+
+    for (int u = 0; u < numUnits; ++u)
+    {
+        levels.push_back(hopSum[u] * scale);
+        hopSum[u] = 0.0f;
+    }
+
+    hopFill = 0;
+}
+
+void LoudnessProfile::finish()
+{
+    if (hopFill > 0)
+        endHop();
+
+    auto numHops = static_cast<int>(levels.size()) / numUnits;
+    reference.resize(levels.size());
+
+    float window[WINDOW_HOPS];
+    const int halfWindow = WINDOW_HOPS / 2;
+
+    for (int u = 0; u < numUnits; ++u)
+    {
+        for (int hop = 0; hop < numHops; ++hop)
+        {
+            auto first = std::max(0, hop - halfWindow);
+            auto end = std::min(numHops, hop + halfWindow + 1);
+            auto count = end - first;
+
+            for (int h = first; h < end; ++h)
+                window[h - first] = levels[static_cast<size_t>(h * numUnits + u)];
+
+            // Drop the loudest quarter, average the rest
+            auto keep = count - count / 4;
+            std::nth_element(window, window + keep - 1, window + count);
+
+            float sum = 0.0f;
+            for (int k = 0; k < keep; ++k)
+                sum += window[k];
+
+            reference[static_cast<size_t>(hop * numUnits + u)] = sum / static_cast<float>(keep);
+        }
+    }
+
+    levels.swap(reference);
+    finished = true;
+}
+
+float LoudnessProfile::getLevel(int unit, juce::int64 position) const
+{
+    if (levels.empty())
+        return 0.0f;
+
+    auto numHops = static_cast<juce::int64>(levels.size()) / numUnits;
+    auto hop = juce::jlimit<juce::int64>(0, numHops - 1, position / hopSize);
+    return levels[static_cast<size_t>(hop * numUnits + unit)];
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "PlosiveDetector.h"
+#include <vector>
+
+// Whole-file low-band level of each detection unit, for offline two-pass
+// rendering. The first pass adds the detection input block by block (the
+// same channel mix the detector sees, interleaved by unit); finish() turns
+// the per-hop levels into the auto-threshold reference, and the second pass
+// reads it back by position instead of running the 500 ms follower.
+//
+// The reference at a hop is the mean low-passed level over about a second
+// centred on it, leaving out the loudest quarter of hops so the plosives
+// themselves don't raise it. Being centred, it sees half a second ahead,
+// and it's valid from the first sample rather than rising from zero.
+//
+// Levels are stored per 20 ms hop: about 0.7 MB per detection unit per hour
+// of audio, so multi-hour files stay small. prepare() keeps the storage
+// allocated for reuse on the next file.
+class LoudnessProfile
+{
+public:
+    static constexpr double HOP_SECONDS = 0.02;
+    static constexpr int WINDOW_HOPS = 51;  // centred on the hop
+
+    // Starts a new profile. The low-pass matches the detector's (same
+    // filter topology and cutoff, Q 0.5); expectedLength, if known, reserves
+    // the storage up front.
+    void prepare(double sampleRate, int numUnits, PlosiveDetector::Filter filter, float lowPassCutoffHz,
+                 juce::int64 expectedLength = 0);
+
+    // First pass: numSamples of interleaved detection input
+    void addBlock(const float* input, int numSamples);
+
+    // Ends the first pass and computes the references
+    void finish();
+
+    bool isFinished() const { return finished; }
+    int getNumUnits() const { return numUnits; }
+    int getHopSize() const { return hopSize; }
+
+    // Second pass: auto-threshold reference of a unit for the hop holding
+    // position. Positions past the end read the last hop.
+    float getLevel(int unit, juce::int64 position) const;
+
+private:
+    int numUnits = 1;
+    int hopSize = 882;
+    bool finished = false;
+
+    // Biquad taps, or the SVF's coefficients; z1/z2 hold either's state
+    PlosiveDetector::Filter filter = PlosiveDetector::Filter::biquad;
+    float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    PlosiveDetector::SvfCoefficients svf {};
+    float z1[PlosiveDetector::MAX_UNITS] = {}, z2[PlosiveDetector::MAX_UNITS] = {};
+    float hopSum[PlosiveDetector::MAX_UNITS] = {};
+    int hopFill = 0;
+
+    std::vector<float> levels;     // hop * numUnits + unit: mean level, then the reference
+    std::vector<float> reference;  // scratch for finish()
+
+    void endHop();
+};
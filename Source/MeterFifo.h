@@ -0,0 +1,25 @@
+#pragma once
+
+#include "RealtimeFifo.h"
+
+// Metering for one processed host block
+struct MeterFrame
+{
+    static constexpr int MAX_CHANNELS = 16;
+
+    int numChannels = 0;
+    int numSamples = 0;
+
+    float peak[MAX_CHANNELS] = {};  // largest input sample magnitude in the block
+    float rms[MAX_CHANNELS] = {};   // input RMS over the block
+
+    float envelope = 0.0f;          // hottest detection envelope at the end of the block
+    float minGain = 1.0f;           // deepest gain applied anywhere in the block
+    bool triggered = false;         // a detector was over its threshold at the end of the block
+};
+
+// The audio thread pushes one frame per block and the editor drains them on
+// its timer, so every block is seen no matter how block size and UI frame
+// rate compare. 1024 frames is about 0.1 s of 16-sample blocks at 192 kHz,
+// i.e. several UI frames of slack.
+using MeterFifo = RealtimeFifo<MeterFrame, 1024>;
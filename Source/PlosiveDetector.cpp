@@ -0,0 +1,575 @@
+#include "PlosiveDetector.h"
+#include "Core/PlosiveCore.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Quiet-path bound for the fast envelope, about 0.9 dB under the -40 dB
+    // trigger floor. The follower's output stays within rounding of the
+    // larger of its previous value and its input, and the margin leaves room
+    // for that rounding to build up over any block length.
+    constexpr float QUIET_LEVEL = 0.009f;
+}
+
+// The biquad recursion y = b0 x + (b1 - a1) y1 + (b2 - a2) y2 is the
+// all-pole filter b0 / (1 + A1 z^-1 + A2 z^-2). A TPT SVF with
+// integrator gain g and damping k has the same poles when
+//   g^2 = (1 + A1 + A2) / (1 - A1 + A2),   k = (1 - A2) N / (2g),
+// with N = 1 + gk + g^2. Its input, band and low outputs then give the
+// constant numerator mixed in the ratio 1 : 2/g - k : 1/g^2 - 1.
+// Everything is written in terms of 1 - cos w0 = sin^2 w0 / (1 + cos w0),
+// so nothing cancels at low cutoffs, and computed in double.
+PlosiveDetector::SvfCoefficients PlosiveDetector::designSvf(float cosw0, float sinw0, float q)
+{
+    double c = cosw0;
+    double oneMinusC = static_cast<double>(sinw0) * sinw0 / (1.0 + c);
+    double alpha = sinw0 / (2.0 * q);
+    double a0 = 1.0 + alpha;
+
+    double b0 = oneMinusC / (2.0 * a0);                  // also 1 + A1 + A2
+    double onePlusA2 = (3.0 + c) / (2.0 * a0);
+    double oneMinusA2 = (oneMinusC / 2.0 + 2.0 * alpha) / a0;
+
+    double g2 = oneMinusC / (5.0 + 3.0 * c);
+    double g = std::sqrt(g2);
+    double n = 2.0 * (1.0 + g2) / onePlusA2;
+    double k = oneMinusA2 * n / (2.0 * g);
+
+    double a1 = 1.0 / (1.0 + g * (g + k));
+    double mix = b0 * n / 4.0;
+
+    return { static_cast<float>(a1), static_cast<float>(g * a1), static_cast<float>(g2 * a1),
+             static_cast<float>(mix), static_cast<float>(mix * (2.0 / g - k)), static_cast<float>(mix * (1.0 / g2 - 1.0)) };
+}
+
+void PlosiveDetector::prepare(double newSampleRate, int newMaxBlockSize)
+{
+    sampleRate = newSampleRate;
+    maxBlockSize = std::max(1, newMaxBlockSize);
+
+    auto fs = static_cast<float>(sampleRate);
+
+    // Envelope time constants
+    // Fast: 1ms attack, 30ms release - catches transients
+    fastAttack = plosive::timeConstantCoefficient(fs, 0.001f);
+    fastRelease = plosive::timeConstantCoefficient(fs, 0.030f);
+
+    // Slow: 20ms attack, 100ms release - tracks sustained content
+    slowAttack = plosive::timeConstantCoefficient(fs, 0.020f);
+    slowRelease = plosive::timeConstantCoefficient(fs, 0.100f);
+
+    // Gain smoothing: ~3ms
+    gainSmoothCoeff = plosive::timeConstantCoefficient(fs, 0.003f);
+
+    // Average level tracking: ~500ms time constant for stable threshold
+    avgFollowCoeff = plosive::timeConstantCoefficient(fs, 0.5f);
+    avgLevelCoeff = avgFollowCoeff;
+
+    auto scratchSize = static_cast<size_t>(MAX_UNITS * maxBlockSize);
+    inputBuffer.assign(scratchSize, 0.0f);
+    triggerBuffer.assign(scratchSize, 0.0f);
+    gateBuffer.assign(scratchSize, 1.0f);
+    gainBuffer.assign(scratchSize, 1.0f);
+
+    reset();
+}
+
+void PlosiveDetector::release()
+{
+    inputBuffer.clear();
+    triggerBuffer.clear();
+    gateBuffer.clear();
+    gainBuffer.clear();
+    maxBlockSize = 0;
+}
+
+void PlosiveDetector::reset()
+{
+    std::fill(std::begin(lpfZ1), std::end(lpfZ1), 0.0f);
+    std::fill(std::begin(lpfZ2), std::end(lpfZ2), 0.0f);
+    std::fill(std::begin(fast), std::end(fast), 0.0f);
+    std::fill(std::begin(slow), std::end(slow), 0.0f);
+    std::fill(std::begin(avg), std::end(avg), 0.0f);
+    std::fill(std::begin(current), std::end(current), 1.0f);
+    std::fill(std::begin(target), std::end(target), 1.0f);
+    std::fill(std::begin(unityGain), std::end(unityGain), false);
+}
+
+void PlosiveDetector::clearGate()
+{
+    std::fill(gateBuffer.begin(), gateBuffer.end(), 1.0f);
+}
+
+void PlosiveDetector::setAverageLevels(const float* levels)
+{
+    // A zero coefficient leaves the follower exactly where it's put
+    std::copy(levels, levels + numUnits, avg);
+    avgLevelCoeff = 0.0f;
+}
+
+void PlosiveDetector::releaseAverageLevels()
+{
+    avgLevelCoeff = avgFollowCoeff;
+}
+
+void PlosiveDetector::saveDetectionState(DetectionState& state) const
+{
+    std::copy(lpfZ1, lpfZ1 + numUnits, state.lpfZ1);
+    std::copy(lpfZ2, lpfZ2 + numUnits, state.lpfZ2);
+    std::copy(fast, fast + numUnits, state.fast);
+    std::copy(slow, slow + numUnits, state.slow);
+    std::copy(avg, avg + numUnits, state.avg);
+}
+
+void PlosiveDetector::restoreDetectionState(const DetectionState& state)
+{
+    std::copy(state.lpfZ1, state.lpfZ1 + numUnits, lpfZ1);
+    std::copy(state.lpfZ2, state.lpfZ2 + numUnits, lpfZ2);
+    std::copy(state.fast, state.fast + numUnits, fast);
+    std::copy(state.slow, state.slow + numUnits, slow);
+    std::copy(state.avg, state.avg + numUnits, avg);
+}
+
+void PlosiveDetector::replayGains(int numSamples, float reductionAmount)
+{
+    const int units = numUnits;
+    const auto* excess = triggerBuffer.data();
+
+    // The target gain of processLog/processLinear with the gate open: a
+    // negative excess means not triggered
+    for (int u = 0; u < units; ++u)
+    {
+        reduction[u] = reductionAmount;
+        auto* gains = gainBuffer.data() + static_cast<size_t>(u * maxBlockSize);
+        float c = current[u], g = target[u];
+        bool unity = true;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto e = excess[i * units + u];
+            g = e >= 0.0f ? plosive::targetGain(plosive::reductionRatio(e), reductionAmount) : 1.0f;
+            c = plosive::smoothGain(c, g, gainSmoothCoeff);
+            gains[i] = plosive::softKnee(c);
+            unity = unity && gains[i] == 1.0f;
+        }
+
+        current[u] = c;
+        target[u] = g;
+        unityGain[u] = unity;
+    }
+}
+
+void PlosiveDetector::setNumUnits(int newNumUnits)
+{
+    newNumUnits = juce::jlimit(1, MAX_UNITS, newNumUnits);
+
+    for (int u = numUnits; u < newNumUnits; ++u)
+    {
+        lpfZ1[u] = lpfZ1[0];
+        lpfZ2[u] = lpfZ2[0];
+        fast[u] = fast[0];
+        slow[u] = slow[0];
+        avg[u] = avg[0];
+        current[u] = current[0];
+        target[u] = target[0];
+    }
+
+    numUnits = newNumUnits;
+}
+
+void PlosiveDetector::setLowPass(float cutoffHz, float q)
+{
+    if (cutoffHz == cachedCutoff && q == cachedQ && sampleRate == cachedSampleRate)
+        return;
+
+    float w0 = 2.0f * plosive::pi<float> * cutoffHz / static_cast<float>(sampleRate);
+    setCoefficients(0, MAX_UNITS, std::cos(w0), std::sin(w0), q);
+
+    cachedCutoff = cutoffHz;
+    cachedQ = q;
+    cachedSampleRate = sampleRate;
+}
+
+void PlosiveDetector::setLowPassCoefficients(float cosw0, float sinw0, float q)
+{
+    // Any direct update invalidates the cache; setLowPass() re-validates it
+    cachedCutoff = -1.0f;
+    setCoefficients(0, MAX_UNITS, cosw0, sinw0, q);
+}
+
+void PlosiveDetector::setFilter(Filter newFilter)
+{
+    if (newFilter == filter)
+        return;
+
+    filter = newFilter;
+    std::fill(std::begin(lpfZ1), std::end(lpfZ1), 0.0f);
+    std::fill(std::begin(lpfZ2), std::end(lpfZ2), 0.0f);
+}
+
+void PlosiveDetector::setUnitLowPass(int unit, float cutoffHz, float q)
+{
+    cachedCutoff = -1.0f;
+
+    float w0 = 2.0f * plosive::pi<float> * cutoffHz / static_cast<float>(sampleRate);
+    setCoefficients(unit, unit + 1, std::cos(w0), std::sin(w0), q);
+}
+
+void PlosiveDetector::setCoefficients(int firstUnit, int endUnit, float cosw0, float sinw0, float q)
+{
+    auto c = plosive::LowPassCoefficients<float>::fromTrig(cosw0, sinw0, q);
+
+    auto svf = designSvf(cosw0, sinw0, q);
+
+    for (int u = firstUnit; u < endUnit; ++u)
+    {
+        b0[u] = c.b0;
+        b1[u] = c.b1;
+        b2[u] = c.b2;
+        a1[u] = c.a1;
+        a2[u] = c.a2;
+
+        svfA1[u] = svf.a1;
+        svfA2[u] = svf.a2;
+        svfA3[u] = svf.a3;
+        svfM0[u] = svf.m0;
+        svfM1[u] = svf.m1;
+        svfM2[u] = svf.m2;
+    }
+}
+
+void PlosiveDetector::setUnitSettings(int unit, float thresholdDb, float reductionAmount)
+{
+    thresholdOffsetDb[unit] = plosive::SENSITIVITY_RANGE_DB - thresholdDb;
+    reduction[unit] = reductionAmount;
+}
+
+void PlosiveDetector::process(int numSamples, float thresholdDb, float reductionAmount, Mode mode)
+{
+    for (int u = 0; u < numUnits; ++u)
+        setUnitSettings(u, thresholdDb, reductionAmount);
+
+    process(numSamples, mode);
+}
+
+void PlosiveDetector::process(int numSamples, Mode mode)
+{
+    // Silence on a detector that hasn't seen signal since reset: the filter
+    // and envelopes would only compute zeros. (After signal, the followers
+    // settle just above zero instead, and silence takes the quiet path.) The
+    // low-pass of zeros is zero, so the input buffer already holds what
+    // lowPass would write.
+    if (isSilent(numSamples))
+    {
+        std::fill(triggerBuffer.begin(), triggerBuffer.begin() + numSamples * numUnits, -1.0f);
+        releaseGains(numSamples);
+        return;
+    }
+
+    lowPass(numSamples);
+
+    // Nothing can trigger, in either mode: every target is 1
+    if (isQuiet(numSamples))
+    {
+        followEnvelopesOnly(numSamples);
+        releaseGains(numSamples);
+        return;
+    }
+
+    if (mode == Mode::linearDomain)
+        processLinear(numSamples);
+    else
+        processLog(numSamples);
+
+    std::fill(unityGain, unityGain + numUnits, false);
+}
+
+bool PlosiveDetector::isSilent(int numSamples) const
+{
+    for (int u = 0; u < numUnits; ++u)
+        if (lpfZ1[u] != 0.0f || lpfZ2[u] != 0.0f || fast[u] != 0.0f || slow[u] != 0.0f || avg[u] != 0.0f)
+            return false;
+
+    float lowest = 0.0f, highest = 0.0f;
+    juce::FloatVectorOperations::findMinAndMax(inputBuffer.data(), numSamples * numUnits, lowest, highest);
+    return lowest == 0.0f && highest == 0.0f;
+}
+
+bool PlosiveDetector::isQuiet(int numSamples) const
+{
+    for (int u = 0; u < numUnits; ++u)
+        if (fast[u] >= QUIET_LEVEL)
+            return false;
+
+    // Low-passed input, every unit at once
+    float lowest = 0.0f, highest = 0.0f;
+    juce::FloatVectorOperations::findMinAndMax(inputBuffer.data(), numSamples * numUnits, lowest, highest);
+    return lowest > -QUIET_LEVEL && highest < QUIET_LEVEL;
+}
+
+void PlosiveDetector::followEnvelopesOnly(int numSamples)
+{
+    const int units = numUnits;
+    const auto* lowFreq = inputBuffer.data();
+
+    float f[MAX_UNITS], s[MAX_UNITS], a[MAX_UNITS];
+    std::copy(fast, fast + units, f);
+    std::copy(slow, slow + units, s);
+    std::copy(avg, avg + units, a);
+
+    // The same updates as the full detectors, without the dB conversion
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto* x = lowFreq + i * units;
+
+        for (int u = 0; u < units; ++u)
+        {
+            float lowFreqAbs = std::abs(x[u]);
+
+            f[u] = plosive::followEnvelope(f[u], lowFreqAbs, fastAttack, fastRelease);
+            s[u] = plosive::followEnvelope(s[u], lowFreqAbs, slowAttack, slowRelease);
+            a[u] += avgLevelCoeff * (lowFreqAbs - a[u]);
+        }
+    }
+
+    std::copy(f, f + units, fast);
+    std::copy(s, s + units, slow);
+    std::copy(a, a + units, avg);
+
+    std::fill(triggerBuffer.begin(), triggerBuffer.begin() + numSamples * units, -1.0f);
+}
+
+void PlosiveDetector::releaseGains(int numSamples)
+{
+    for (int u = 0; u < numUnits; ++u)
+    {
+        auto* gains = gainBuffer.data() + static_cast<size_t>(u * maxBlockSize);
+        float c = current[u];
+        target[u] = 1.0f;
+
+        // Once the smoother stops moving (at 1, or within rounding of it) the
+        // gain is the same for every sample
+        if (plosive::smoothGain(c, 1.0f, gainSmoothCoeff) == c)
+        {
+            auto gain = plosive::softKnee(c);
+            juce::FloatVectorOperations::fill(gains, gain, numSamples);
+            unityGain[u] = gain == 1.0f;
+            continue;
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            c = plosive::smoothGain(c, 1.0f, gainSmoothCoeff);
+            gains[i] = plosive::softKnee(c);
+        }
+
+        current[u] = c;
+        unityGain[u] = false;
+    }
+}
+
+void PlosiveDetector::lowPass(int numSamples)
+{
+    if (filter == Filter::svf)
+    {
+        lowPassSvf(numSamples);
+        return;
+    }
+
+    const int units = numUnits;
+    auto* data = inputBuffer.data();
+
+    // Local copies keep the recursion in registers and free of aliasing
+    float s1[MAX_UNITS], s2[MAX_UNITS];
+    std::copy(lpfZ1, lpfZ1 + units, s1);
+    std::copy(lpfZ2, lpfZ2 + units, s2);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto* x = data + i * units;
+
+        for (int u = 0; u < units; ++u)
+        {
+            float output = b0[u] * x[u] + b1[u] * s1[u] + b2[u] * s2[u] - a1[u] * s1[u] - a2[u] * s2[u];
+            s2[u] = s1[u];
+            s1[u] = output;
+            x[u] = output;
+        }
+    }
+
+    std::copy(s1, s1 + units, lpfZ1);
+    std::copy(s2, s2 + units, lpfZ2);
+}
+
+void PlosiveDetector::lowPassSvf(int numSamples)
+{
+    const int units = numUnits;
+    auto* data = inputBuffer.data();
+
+    float ic1[MAX_UNITS], ic2[MAX_UNITS];
+    std::copy(lpfZ1, lpfZ1 + units, ic1);
+    std::copy(lpfZ2, lpfZ2 + units, ic2);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto* x = data + i * units;
+
+        for (int u = 0; u < units; ++u)
+        {
+            float v3 = x[u] - ic2[u];
+            float v1 = svfA1[u] * ic1[u] + svfA2[u] * v3;
+            float v2 = ic2[u] + svfA2[u] * ic1[u] + svfA3[u] * v3;
+            float output = svfM0[u] * x[u] + svfM1[u] * v1 + svfM2[u] * v2;
+            ic1[u] = 2.0f * v1 - ic1[u];
+            ic2[u] = 2.0f * v2 - ic2[u];
+            x[u] = output;
+        }
+    }
+
+    std::copy(ic1, ic1 + units, lpfZ1);
+    std::copy(ic2, ic2 + units, lpfZ2);
+}
+
+void PlosiveDetector::processLog(int numSamples)
+{
+    const int units = numUnits;
+    const auto* lowFreq = inputBuffer.data();
+    auto* excess = triggerBuffer.data();
+    const auto* gate = gateBuffer.data();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto* x = lowFreq + i * units;
+        const auto* g = gate + i * units;
+        auto* e = excess + i * units;
+
+        for (int u = 0; u < units; ++u)
+        {
+            float lowFreqAbs = std::abs(x[u]);
+
+            // Fast envelope (catches transients) - 0.5ms attack
+            fast[u] = plosive::followEnvelope(fast[u], lowFreqAbs, fastAttack, fastRelease);
+
+            // Slow envelope (tracks sustained content) - 50ms attack
+            slow[u] = plosive::followEnvelope(slow[u], lowFreqAbs, slowAttack, slowRelease);
+
+            // Track average low-frequency level (slow follower for stable reference)
+            avg[u] += avgLevelCoeff * (lowFreqAbs - avg[u]);
+
+            // Convert to dB
+            float envelopeDb = plosive::levelToDb(fast[u]);
+            float avgLevelDb = plosive::levelToDb(avg[u]);
+
+            // Sensitivity control: how many dB above average to trigger
+            // Higher sensitivity value = triggers on smaller spikes (more sensitive)
+            // sensitivity=24 means trigger when 0dB above average (very sensitive)
+            // sensitivity=0 means trigger when 24dB above average (not sensitive)
+            float triggerThresholdDb = avgLevelDb + thresholdOffsetDb[u];
+
+            // Calculate target gain reduction
+            float gainTarget = 1.0f;
+            e[u] = -1.0f;
+
+            // Trigger when fast envelope exceeds threshold
+            // Must also exceed absolute minimum to avoid triggering on silence,
+            // and the spectral gate (if any) must be open
+            bool hasEnergy = (envelopeDb > triggerThresholdDb) && (envelopeDb > plosive::TRIGGER_FLOOR_DB) && g[u] > 0.0f;
+
+            if (hasEnergy)
+            {
+                // Proportional reduction based on how much we exceed threshold
+                float excessDb = envelopeDb - triggerThresholdDb;
+                gainTarget = plosive::targetGain(plosive::reductionRatio(excessDb) * g[u], reduction[u]);
+                e[u] = excessDb;
+            }
+
+            // Smooth gain changes: faster attack to catch the plosive, slower
+            // release to avoid clicks on recovery
+            current[u] = plosive::smoothGain(current[u], gainTarget, gainSmoothCoeff);
+            target[u] = gainTarget;
+
+            // Soft knee: blend linear and squared gain for smoother perceived volume change
+            gainBuffer[static_cast<size_t>(u * maxBlockSize + i)] = plosive::softKnee(current[u]);
+        }
+    }
+}
+
+void PlosiveDetector::processLinear(int numSamples)
+{
+    const int units = numUnits;
+    const int total = numSamples * units;
+    auto* envelope = inputBuffer.data();   // low-passed input -> fast envelope -> ratio
+    auto* trigger = triggerBuffer.data();
+    const auto* gate = gateBuffer.data();
+
+    // The dB offsets of the log detector, as linear factors computed once per block.
+    // The log detector floors levels at -100 dB, i.e. 0.00001.
+    float sensitivityGain[MAX_UNITS];
+    for (int u = 0; u < units; ++u)
+        sensitivityGain[u] = juce::Decibels::decibelsToGain(thresholdOffsetDb[u]);
+
+    const float minAvgLevel = plosive::LEVEL_FLOOR;
+    const float minEnvelope = 0.01f; // -40 dB absolute trigger floor
+
+    float f[MAX_UNITS], s[MAX_UNITS], a[MAX_UNITS];
+    std::copy(fast, fast + units, f);
+    std::copy(slow, slow + units, s);
+    std::copy(avg, avg + units, a);
+
+    // Pass 1: envelope followers (serial in time, vectorized across units)
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto* x = envelope + i * units;
+        auto* t = trigger + i * units;
+
+        for (int u = 0; u < units; ++u)
+        {
+            float lowFreqAbs = std::abs(x[u]);
+
+            f[u] = plosive::followEnvelope(f[u], lowFreqAbs, fastAttack, fastRelease);
+            s[u] = plosive::followEnvelope(s[u], lowFreqAbs, slowAttack, slowRelease);
+            a[u] += avgLevelCoeff * (lowFreqAbs - a[u]);
+
+            x[u] = f[u];
+            t[u] = std::max(a[u], minAvgLevel) * sensitivityGain[u];
+        }
+    }
+
+    std::copy(f, f + units, fast);
+    std::copy(s, s + units, slow);
+    std::copy(a, a + units, avg);
+
+    // Pass 2: reduction ratio (full reduction at 6dB over threshold).
+    // Branch-free over the whole block; the log only matters when triggered.
+    for (int i = 0; i < total; ++i)
+    {
+        float env = envelope[i];
+        float excessDb = fastGainToDecibels(std::max(env / trigger[i], 1.0f));
+        float r = plosive::reductionRatio(excessDb);
+        bool triggered = env > trigger[i] && env > minEnvelope && gate[i] > 0.0f;
+        envelope[i] = triggered ? r * gate[i] : 0.0f;
+        trigger[i] = triggered ? excessDb : -1.0f;
+    }
+
+    // Pass 3: target gain and attack/release smoothing, as in the log detector
+    float c[MAX_UNITS], g[MAX_UNITS];
+    std::copy(current, current + units, c);
+    std::copy(target, target + units, g);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto* ratio = envelope + i * units;
+
+        for (int u = 0; u < units; ++u)
+        {
+            g[u] = plosive::targetGain(ratio[u], reduction[u]);
+            c[u] = plosive::smoothGain(c[u], g[u], gainSmoothCoeff);
+            gainBuffer[static_cast<size_t>(u * maxBlockSize + i)] = plosive::softKnee(c[u]);
+        }
+    }
+
+    std::copy(c, c + units, current);
+    std::copy(g, g + units, target);
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+// Plosive detector with up to MAX_UNITS independent detection units (one per
+// linked group of channels). Each unit runs the low-pass, fast/slow envelopes,
+// auto-threshold and gain smoother. State is stored structure-of-arrays and the
+// per-sample loops iterate over units innermost, so extra units vectorize
+// instead of costing a full detector each.
+class PlosiveDetector
+{
+public:
+    static constexpr int MAX_UNITS = 16;
+
+    // logDomain is the original per-sample dB comparison. linearDomain compares
+    // the envelope against a linear threshold computed once per block and only
+    // takes an approximate log of the excess; its gain curve tracks logDomain
+    // to within ~0.01 dB.
+    enum class Mode { logDomain, linearDomain };
+
+    // Detection low-pass topology. biquad is the original direct-form
+    // recursion, as in plosive::Detector: the RBJ coefficients with every tap
+    // on past outputs, which makes it a two-pole low-pass. svf realises the
+    // same transfer function as a TPT state-variable filter with a mixed
+    // output. Its coefficients stay well conditioned when the cutoff is a
+    // small fraction of the sample rate (100 Hz at 192 kHz), where the
+    // biquad's feedback taps approach 2 and -1 and float loses most of the
+    // response. It also tolerates the cutoff changing every sub-block.
+    enum class Filter { biquad, svf };
+
+    // Allocates scratch for MAX_UNITS * maxBlockSize samples and resets all units
+    void prepare(double sampleRate, int maxBlockSize);
+    void release();
+    void reset();
+
+    int getMaxBlockSize() const { return maxBlockSize; }
+
+    // Changing the unit count never allocates. Units that weren't running start
+    // from unit 0's state, so they don't have to re-learn the auto-threshold.
+    void setNumUnits(int newNumUnits);
+    int getNumUnits() const { return numUnits; }
+
+    // Detection low-pass coefficients for every unit. setLowPass only
+    // recomputes when cutoff, Q or sample rate change; setLowPassCoefficients
+    // takes a precomputed cos/sin of w0 (used while the cutoff is ramping).
+    void setLowPass(float cutoffHz, float q);
+    void setLowPassCoefficients(float cosw0, float sinw0, float q);
+
+    // Switching clears every unit's filter state
+    void setFilter(Filter newFilter);
+    Filter getFilter() const { return filter; }
+
+    // The svf filter's integrator coefficients a1-a3 and output mix m0-m2
+    // (input, band, low) for the biquad low-pass with the same cos/sin of w0
+    // and Q. Shared with LoudnessProfile, which runs the same recursion.
+    struct SvfCoefficients
+    {
+        float a1, a2, a3, m0, m1, m2;
+    };
+
+    static SvfCoefficients designSvf(float cosw0, float sinw0, float q);
+
+    // Per-unit settings, for units that run independent chains (see
+    // PlosiveSessionEngine). Used by process(numSamples, mode).
+    void setUnitLowPass(int unit, float cutoffHz, float q);
+    void setUnitSettings(int unit, float thresholdDb, float reductionAmount);
+
+    // Offline two-pass rendering (see LoudnessProfile): holds each unit's
+    // average level, the auto-threshold reference, at levels[unit] instead of
+    // following the input, until releaseAverageLevels().
+    void setAverageLevels(const float* levels);
+    void releaseAverageLevels();
+
+    // Interleaved detection input, input[i * numUnits + unit]. Fill it, then
+    // call process(); the contents are overwritten.
+    float* getInputBuffer() { return inputBuffer.data(); }
+
+    // Optional per-sample gate, 0-1, interleaved like the input. It scales
+    // each unit's reduction and a closed gate (0) blocks triggering. Holds
+    // 1 (no effect) until written; clearGate() restores that.
+    float* getGateBuffer() { return gateBuffer.data(); }
+    void clearGate();
+
+    // Runs every unit over numSamples (<= getMaxBlockSize()) of the input
+    // buffer. The first form gives all units the same settings.
+    //
+    // Quiescent blocks take a shorter path with identical results. If the
+    // input is silent and every filter and envelope state is zero, nothing is
+    // computed but the gain. If no unit's envelope can reach the trigger floor
+    // in this block, only the envelope followers run; the dB conversion and
+    // trigger logic are skipped. Either way, a gain smoother that has settled
+    // fills its gains instead of stepping per sample.
+    void process(int numSamples, float thresholdDb, float reductionAmount, Mode mode);
+    void process(int numSamples, Mode mode);
+
+    // Per-sample output gain of a unit from the last process() call
+    const float* getGains(int unit) const { return gainBuffer.data() + static_cast<size_t>(unit * maxBlockSize); }
+
+    // True when every gain of the unit from the last process() call was
+    // exactly 1, so applying them can be skipped
+    bool hasUnityGain(int unit) const { return unityGain[unit]; }
+
+    // Per-sample dB over the trigger threshold from the last process() call,
+    // interleaved like the input; negative while a unit isn't triggered
+    const float* getExcessDb() const { return triggerBuffer.data(); }
+
+    // Everything but the gain smoothers: filter, envelopes and average level
+    // of every unit. Together with the excess of a block, it's what
+    // replayGains needs to reproduce that block and carry on after it (see
+    // GainEnvelopeCache).
+    struct DetectionState
+    {
+        float lpfZ1[MAX_UNITS] = {}, lpfZ2[MAX_UNITS] = {};
+        float fast[MAX_UNITS] = {}, slow[MAX_UNITS] = {}, avg[MAX_UNITS] = {};
+    };
+
+    void saveDetectionState(DetectionState& state) const;
+    void restoreDetectionState(const DetectionState& state);
+
+    // Runs only the gain smoothers, at reductionAmount for every unit, from a
+    // block's excess written to getExcessBuffer() in getExcessDb()'s layout.
+    // Without a spectral gate this matches what process() computed for that
+    // block bit for bit, at any reduction.
+    float* getExcessBuffer() { return triggerBuffer.data(); }
+    void replayGains(int numSamples, float reductionAmount);
+
+    float getEnvelope(int unit) const { return fast[unit]; }
+    float getGainReduction(int unit) const { return current[unit]; }
+    bool isTriggered(int unit) const { return target[unit] < 1.0f; }
+
+private:
+    void lowPass(int numSamples);
+    void lowPassSvf(int numSamples);
+    void processLog(int numSamples);
+    void processLinear(int numSamples);
+
+    bool isSilent(int numSamples) const;
+    bool isQuiet(int numSamples) const;
+    void followEnvelopesOnly(int numSamples);
+    void releaseGains(int numSamples);
+    void setCoefficients(int firstUnit, int endUnit, float cosw0, float sinw0, float q);
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int numUnits = 1;
+
+    // Detection low-pass per unit, and the key setLowPass last computed for all of them
+    float b0[MAX_UNITS] = {}, b1[MAX_UNITS] = {}, b2[MAX_UNITS] = {}, a1[MAX_UNITS] = {}, a2[MAX_UNITS] = {};
+    float cachedCutoff = -1.0f, cachedQ = -1.0f;
+    double cachedSampleRate = 0.0;
+
+    // The same low-pass as a TPT state-variable filter: integrator
+    // coefficients a1-a3 and output mix m0-m2 (input, band, low)
+    Filter filter = Filter::biquad;
+    float svfA1[MAX_UNITS] = {}, svfA2[MAX_UNITS] = {}, svfA3[MAX_UNITS] = {};
+    float svfM0[MAX_UNITS] = {}, svfM1[MAX_UNITS] = {}, svfM2[MAX_UNITS] = {};
+
+    // Time constants
+    float fastAttack = 0.0f, fastRelease = 0.0f;
+    float slowAttack = 0.0f, slowRelease = 0.0f;
+    float avgLevelCoeff = 0.0f;         // 0 while the average levels are held
+    float avgFollowCoeff = 0.0f;
+    float gainSmoothCoeff = 0.0f;
+
+    // Per-unit settings: dB over the average level that triggers (24 - sensitivity), and reduction 0-1
+    float thresholdOffsetDb[MAX_UNITS] = {};
+    float reduction[MAX_UNITS] = {};
+
+    // Per-unit state. The filter state is the biquad's two previous outputs,
+    // or the SVF's two integrator states.
+    float lpfZ1[MAX_UNITS] = {}, lpfZ2[MAX_UNITS] = {};
+    float fast[MAX_UNITS] = {};      // Fast attack for transient detection
+    float slow[MAX_UNITS] = {};      // Slow for sustained content
+    float avg[MAX_UNITS] = {};       // Auto-threshold: average low-frequency level
+    float current[MAX_UNITS] = {};   // Smoothed gain reduction
+    float target[MAX_UNITS] = {};
+    bool unityGain[MAX_UNITS] = {};
+
+    std::vector<float> inputBuffer;    // interleaved: input -> low-passed -> envelope -> ratio
+    std::vector<float> triggerBuffer;  // interleaved: trigger level (linear mode) -> excess dB
+    std::vector<float> gateBuffer;     // interleaved
+    std::vector<float> gainBuffer;     // planar: unit * maxBlockSize + i
+};
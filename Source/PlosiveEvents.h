@@ -0,0 +1,109 @@
+#pragma once
+
+#include "PlosiveDetector.h"
+#include "RealtimeFifo.h"
+
+// One detected plosive. Sample positions are on the input timeline, which is
+// also the output timeline once the host compensates for the look-ahead.
+struct PlosiveEvent
+{
+    juce::int64 onsetSample = 0;
+    int lengthSamples = 0;
+    float peakExcessDb = 0.0f;  // furthest the envelope went over the trigger threshold
+    float minGain = 1.0f;       // lowest gain applied while the event was open
+    int unit = 0;               // detection unit; always 0 when channels are linked
+};
+
+using PlosiveEventQueue = RealtimeFifo<PlosiveEvent, 1024>;
+
+// Turns the detector's per-sample trigger state into PlosiveEvents. An event
+// opens on the first triggered sample and closes once a unit has been quiet
+// for longer than the merge gap, so a plosive that flickers around the
+// threshold is reported once.
+class PlosiveEventTracker
+{
+public:
+    void prepare(double sampleRate)
+    {
+        mergeGapSamples = static_cast<int>(sampleRate * 0.010); // 10ms
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& state : units)
+            state = UnitState{};
+    }
+
+    // Scans the chunk the detector just processed; startSample is the input
+    // position of its first sample
+    void process(const PlosiveDetector& detector, int numSamples, juce::int64 startSample, PlosiveEventQueue& queue)
+    {
+        const int numUnits = detector.getNumUnits();
+        const auto* excessDb = detector.getExcessDb();
+
+        for (int unit = 0; unit < numUnits; ++unit)
+        {
+            auto& state = units[unit];
+            const auto* gains = detector.getGains(unit);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto excess = excessDb[i * numUnits + unit];
+                auto position = startSample + i;
+
+                if (excess >= 0.0f)
+                {
+                    if (!state.open)
+                    {
+                        state.open = true;
+                        state.event = PlosiveEvent{};
+                        state.event.onsetSample = position;
+                        state.event.unit = unit;
+                    }
+
+                    state.event.peakExcessDb = std::max(state.event.peakExcessDb, excess);
+                    state.lastTriggered = position;
+                }
+                else if (!state.open)
+                {
+                    continue;
+                }
+                else if (position - state.lastTriggered > mergeGapSamples)
+                {
+                    close(state, queue);
+                    continue;
+                }
+
+                state.event.minGain = std::min(state.event.minGain, gains[i]);
+            }
+        }
+    }
+
+    // Closes every open event, e.g. at the end of an offline render or when
+    // the unit layout changes
+    void flush(PlosiveEventQueue& queue)
+    {
+        for (auto& state : units)
+            if (state.open)
+                close(state, queue);
+    }
+
+private:
+    struct UnitState
+    {
+        bool open = false;
+        juce::int64 lastTriggered = 0;
+        PlosiveEvent event;
+    };
+
+    static void close(UnitState& state, PlosiveEventQueue& queue)
+    {
+        state.event.lengthSamples = static_cast<int>(state.lastTriggered - state.event.onsetSample + 1);
+        state.open = false;
+        queue.push(state.event);
+    }
+
+    UnitState units[PlosiveDetector::MAX_UNITS];
+    int mergeGapSamples = 0;
+};
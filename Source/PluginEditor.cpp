@@ -7,11 +7,7 @@ PlosiveRemoverEditor::PlosiveRemoverEditor(PlosiveRemoverProcessor& p)
     // Threshold slider
     thresholdSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
     thresholdSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 80, 20);
-    thresholdSlider.setRange(0.0, 24.0, 0.1);
-    thresholdSlider.setValue(processorRef.threshold->get());
-    thresholdSlider.onValueChange = [this] {
-        *processorRef.threshold = (float)thresholdSlider.getValue();
-    };
+    thresholdAttachment = std::make_unique<SliderAttachment>(processorRef.parameters, "threshold", thresholdSlider);
     addAndMakeVisible(thresholdSlider);
 
     thresholdLabel.setText("Sensitivity", juce::dontSendNotification);
@@ -21,11 +17,7 @@ PlosiveRemoverEditor::PlosiveRemoverEditor(PlosiveRemoverProcessor& p)
     // Reduction slider
     reductionSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
     reductionSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 80, 20);
-    reductionSlider.setRange(0.0, 100.0, 1.0);
-    reductionSlider.setValue(processorRef.reduction->get());
-    reductionSlider.onValueChange = [this] {
-        *processorRef.reduction = (float)reductionSlider.getValue();
-    };
+    reductionAttachment = std::make_unique<SliderAttachment>(processorRef.parameters, "reduction", reductionSlider);
     addAndMakeVisible(reductionSlider);
 
     reductionLabel.setText("Reduction", juce::dontSendNotification);
@@ -35,18 +27,75 @@ PlosiveRemoverEditor::PlosiveRemoverEditor(PlosiveRemoverProcessor& p)
     // Frequency slider
     frequencySlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
     frequencySlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 80, 20);
-    frequencySlider.setRange(100.0, 400.0, 1.0);
-    frequencySlider.setValue(processorRef.frequency->get());
-    frequencySlider.onValueChange = [this] {
-        *processorRef.frequency = (float)frequencySlider.getValue();
-    };
+    frequencyAttachment = std::make_unique<SliderAttachment>(processorRef.parameters, "frequency", frequencySlider);
     addAndMakeVisible(frequencySlider);
 
     frequencyLabel.setText("Frequency", juce::dontSendNotification);
     frequencyLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(frequencyLabel);
 
-    setSize(400, 280);
+    // Look-ahead slider (ms); changes the reported latency
+    lookaheadSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
+    lookaheadSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 80, 20);
+    lookaheadAttachment = std::make_unique<SliderAttachment>(processorRef.parameters, "lookahead", lookaheadSlider);
+    addAndMakeVisible(lookaheadSlider);
+
+    lookaheadLabel.setText("Look-ahead", juce::dontSendNotification);
+    lookaheadLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(lookaheadLabel);
+
+    // Split-band toggle: duck only below the frequency cutoff
+    splitBandAttachment = std::make_unique<ButtonAttachment>(processorRef.parameters, "splitband", splitBandButton);
+    addAndMakeVisible(splitBandButton);
+
+    // Spectral gate: only reduce frames that look like a plosive in the FFT
+    spectralAttachment = std::make_unique<ButtonAttachment>(processorRef.parameters, "spectral", spectralButton);
+    addAndMakeVisible(spectralButton);
+
+    // Detection link for multichannel layouts (item IDs are choice index + 1)
+    linkBox.addItemList(processorRef.link->choices, 1);
+    linkAttachment = std::make_unique<ComboBoxAttachment>(processorRef.parameters, "link", linkBox);
+    addAndMakeVisible(linkBox);
+
+    // Spectral repair: reduce only the bins below the cutoff, with a
+    // selectable FFT size (latency against low-end resolution)
+    repairAttachment = std::make_unique<ButtonAttachment>(processorRef.parameters, "repair", repairButton);
+    addAndMakeVisible(repairButton);
+
+    repairFftBox.addItemList(processorRef.repairFftSize->choices, 1);
+    repairFftAttachment = std::make_unique<ComboBoxAttachment>(processorRef.parameters, "repairfft", repairFftBox);
+    addAndMakeVisible(repairFftBox);
+
+    // Detection filter topology; the SVF stays accurate at high sample rates
+    detectionFilterBox.addItemList(processorRef.detectionFilter->choices, 1);
+    detectionFilterAttachment = std::make_unique<ComboBoxAttachment>(processorRef.parameters, "detfilter", detectionFilterBox);
+    addAndMakeVisible(detectionFilterBox);
+
+    // Optional scrolling gain-reduction view; the window grows to fit it
+    historyButton.onClick = [this] { showHistory(historyButton.getToggleState()); };
+    addAndMakeVisible(historyButton);
+
+    // A/B/C snapshots: one lit button for the active slot
+    const char* const snapshotNames[] = { "A", "B", "C" };
+    static_assert(std::size(snapshotNames) == PlosiveRemoverProcessor::NUM_SNAPSHOTS);
+
+    for (int slot = 0; slot < PlosiveRemoverProcessor::NUM_SNAPSHOTS; ++slot)
+    {
+        auto& button = snapshotButtons[slot];
+        button.setButtonText(snapshotNames[slot]);
+        button.setClickingTogglesState(true);
+        button.setRadioGroupId(1);
+        button.setToggleState(slot == processorRef.getActiveSnapshot(), juce::dontSendNotification);
+        button.onClick = [this, slot] { processorRef.selectSnapshot(slot); };
+        addAndMakeVisible(button);
+    }
+
+    // paint covers every pixel, so nothing behind the editor needs drawing
+    setOpaque(true);
+    setSize(560, 310);
+
+    // Frames queued while no editor was open are stale
+    processorRef.meterFifo.drain([](const MeterFrame&) {});
 
     // Start timer for meter updates (30fps)
     startTimerHz(30);
@@ -59,10 +108,29 @@ PlosiveRemoverEditor::~PlosiveRemoverEditor()
 
 void PlosiveRemoverEditor::timerCallback()
 {
+    // Fold every block processed since the last tick into one set of targets,
+    // so short peaks and brief reductions aren't missed between frames
+    float targetInput = 0.0f;
+    float targetInputRms = 0.0f;
+    float targetDetection = 0.0f;
+    float targetReduction = 0.0f;
+    bool triggered = false;
+
+    processorRef.meterFifo.drain([&](const MeterFrame& frame) {
+        for (int channel = 0; channel < frame.numChannels; ++channel)
+        {
+            targetInput = std::max(targetInput, frame.peak[channel]);
+            targetInputRms = std::max(targetInputRms, frame.rms[channel]);
+        }
+
+        targetDetection = std::max(targetDetection, frame.envelope);
+        targetReduction = std::max(targetReduction, 1.0f - frame.minGain);
+        triggered = triggered || frame.triggered;
+    });
+
+    displayTriggered = triggered;
+
     // Smooth meter values for display
-    float targetInput = processorRef.getInputLevelMeter();
-    float targetDetection = processorRef.getDetectionLevelMeter();
-    float targetReduction = processorRef.getGainReductionMeter();
 
     // Fast attack, slow release for meters
     auto updateMeter = [](float& current, float target) {
@@ -73,13 +141,73 @@ void PlosiveRemoverEditor::timerCallback()
     };
 
     updateMeter(displayInputLevel, targetInput);
+    updateMeter(displayInputRms, targetInputRms);
     updateMeter(displayDetectionLevel, targetDetection);
     updateMeter(displayGainReduction, targetReduction);
 
-    repaint();
+    // Averaged over the last second or so; per-frame values jump around too much to read
+    auto load = static_cast<float>(processorRef.profiler.getLoad(loadReading));
+    displayCpuLoad += 0.05f * (load - displayCpuLoad);
+
+    // The history records every tick, shown or not
+    reductionHistory[static_cast<size_t>(historyWrite)] = targetReduction;
+    historyWrite = (historyWrite + 1) % HISTORY_LENGTH;
+
+    // Only a reduction deep enough to draw a pixel counts: the gain smoother
+    // settles a hair under unity, not at it
+    bool drawsReduction = juce::roundToInt(targetReduction * static_cast<float>(HISTORY_HEIGHT)) > 0;
+    ticksSinceReduction = drawsReduction ? 0 : std::min(ticksSinceReduction + 1, HISTORY_LENGTH + 1);
+
+    // Repaint only what moved; a still meter costs nothing
+    auto state = computeMeterState();
+
+    if (state.inputPeakWidth != meterState.inputPeakWidth || state.inputRmsWidth != meterState.inputRmsWidth)
+        repaint(inputMeterArea);
+
+    if (state.detectionWidth != meterState.detectionWidth || state.triggered != meterState.triggered)
+        repaint(detectionMeterArea);
+
+    if (state.reductionWidth != meterState.reductionWidth)
+        repaint(reductionMeterArea);
+
+    if (state.sensitivityTenths != meterState.sensitivityTenths || state.detectionTenths != meterState.detectionTenths
+        || state.cpuHundredths != meterState.cpuHundredths)
+        repaint(statusArea);
+
+    // Scrolls until the last reduction has left the view
+    if (!historyArea.isEmpty() && ticksSinceReduction <= std::min(HISTORY_LENGTH, historyArea.getWidth()))
+        repaint(historyArea);
+
+    meterState = state;
 }
 
-void PlosiveRemoverEditor::paint(juce::Graphics& g)
+PlosiveRemoverEditor::MeterState PlosiveRemoverEditor::computeMeterState() const
+{
+    MeterState state;
+
+    // Peak in dark green with the RMS level over it
+    auto inputWidth = static_cast<float>(inputMeterArea.getWidth());
+    state.inputPeakWidth = static_cast<int>(std::min(1.0f, displayInputLevel) * inputWidth);
+    state.inputRmsWidth = static_cast<int>(std::min(1.0f, displayInputRms) * inputWidth);
+
+    // Scale detection for visibility (it's usually small values)
+    float scaledDetection = std::min(1.0f, displayDetectionLevel * 10.0f);
+    state.detectionWidth = static_cast<int>(scaledDetection * static_cast<float>(detectionMeterArea.getWidth()));
+    state.triggered = displayTriggered;
+
+    state.reductionWidth = static_cast<int>(displayGainReduction * static_cast<float>(reductionMeterArea.getWidth()));
+
+    float detectionDb = (displayDetectionLevel > 0.00001f)
+        ? 20.0f * std::log10(displayDetectionLevel)
+        : -100.0f;
+    state.sensitivityTenths = juce::roundToInt(processorRef.threshold->get() * 10.0f);
+    state.detectionTenths = juce::roundToInt(detectionDb * 10.0f);
+    state.cpuHundredths = juce::roundToInt(displayCpuLoad * 10000.0f);
+
+    return state;
+}
+
+void PlosiveRemoverEditor::drawBackground(juce::Graphics& g)
 {
     g.fillAll(juce::Colour(0xff1a1a2e));
 
@@ -91,69 +219,131 @@ void PlosiveRemoverEditor::paint(juce::Graphics& g)
     g.drawText("Plosive Remover", getLocalBounds().removeFromTop(40),
                juce::Justification::centred, true);
 
-    // Draw meters at the bottom
-    auto meterArea = getLocalBounds().reduced(20).removeFromBottom(60);
+    // Meter troughs and captions
+    g.setFont(12.0f);
 
-    // Input level meter
-    auto inputMeterArea = meterArea.removeFromLeft(meterArea.getWidth() / 3).reduced(5);
-    g.setColour(juce::Colours::grey);
-    g.fillRoundedRectangle(inputMeterArea.toFloat(), 4.0f);
+    auto drawTrough = [&g](juce::Rectangle<int> area, const juce::String& caption) {
+        g.setColour(juce::Colours::grey);
+        g.fillRoundedRectangle(area.toFloat(), 4.0f);
 
-    float inputMeterWidth = displayInputLevel * inputMeterArea.getWidth();
-    g.setColour(juce::Colours::green);
-    g.fillRoundedRectangle(inputMeterArea.removeFromLeft((int)inputMeterWidth).toFloat(), 4.0f);
+        g.setColour(juce::Colours::white);
+        g.drawText(caption, area.getX(), area.getBottom() + 2, area.getWidth(), 15, juce::Justification::centred);
+    };
 
-    g.setColour(juce::Colours::white);
-    g.setFont(12.0f);
-    g.drawText("Input", inputMeterArea.getX(), inputMeterArea.getBottom() + 2,
-               inputMeterArea.getWidth(), 15, juce::Justification::centred);
+    drawTrough(inputMeterArea, "Input");
+    drawTrough(detectionMeterArea, "Detection");
+    drawTrough(reductionMeterArea, "Reduction");
 
-    // Detection level meter (shows low-freq envelope)
-    auto detectionMeterArea = meterArea.removeFromLeft(meterArea.getWidth() / 2).reduced(5);
-    g.setColour(juce::Colours::grey);
-    g.fillRoundedRectangle(detectionMeterArea.toFloat(), 4.0f);
+    if (!historyArea.isEmpty())
+    {
+        g.setColour(juce::Colours::grey.withAlpha(0.3f));
+        g.fillRect(historyArea);
+    }
+}
 
-    // Scale detection for visibility (it's usually small values)
-    float scaledDetection = std::min(1.0f, displayDetectionLevel * 10.0f);
-    float detectionMeterWidth = scaledDetection * detectionMeterArea.getWidth();
-    g.setColour(juce::Colours::yellow);
-    g.fillRoundedRectangle(detectionMeterArea.removeFromLeft((int)detectionMeterWidth).toFloat(), 4.0f);
+void PlosiveRemoverEditor::paint(juce::Graphics& g)
+{
+    // Static layers come from an image at the display's pixel scale, so they
+    // stay sharp on high-DPI screens
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
 
-    g.setColour(juce::Colours::white);
-    g.drawText("Detection", detectionMeterArea.getX(), detectionMeterArea.getBottom() + 2,
-               detectionMeterArea.getWidth(), 15, juce::Justification::centred);
+    if (!background.isValid() || scale != backgroundScale)
+    {
+        background = juce::Image(juce::Image::RGB, juce::roundToInt(static_cast<float>(getWidth()) * scale),
+                                 juce::roundToInt(static_cast<float>(getHeight()) * scale), false);
+        backgroundScale = scale;
 
-    // Gain reduction meter
-    auto reductionMeterArea = meterArea.reduced(5);
-    g.setColour(juce::Colours::grey);
-    g.fillRoundedRectangle(reductionMeterArea.toFloat(), 4.0f);
+        juce::Graphics imageGraphics(background);
+        imageGraphics.addTransform(juce::AffineTransform::scale(scale));
+        drawBackground(imageGraphics);
+    }
 
-    float reductionMeterWidth = displayGainReduction * reductionMeterArea.getWidth();
-    g.setColour(juce::Colours::red);
-    g.fillRoundedRectangle(reductionMeterArea.removeFromLeft((int)reductionMeterWidth).toFloat(), 4.0f);
+    g.drawImageTransformed(background, juce::AffineTransform::scale(1.0f / scale));
 
-    g.setColour(juce::Colours::white);
-    g.drawText("Reduction", reductionMeterArea.getX(), reductionMeterArea.getBottom() + 2,
-               reductionMeterArea.getWidth(), 15, juce::Justification::centred);
+    // Only the parts inside the area being repainted are drawn
+    if (g.clipRegionIntersects(inputMeterArea))
+    {
+        g.setColour(juce::Colours::darkgreen);
+        g.fillRoundedRectangle(inputMeterArea.withWidth(meterState.inputPeakWidth).toFloat(), 4.0f);
+
+        g.setColour(juce::Colours::green);
+        g.fillRoundedRectangle(inputMeterArea.withWidth(meterState.inputRmsWidth).toFloat(), 4.0f);
+    }
+
+    // Detection level meter (shows low-freq envelope)
+    if (g.clipRegionIntersects(detectionMeterArea))
+    {
+        g.setColour(meterState.triggered ? juce::Colours::orange : juce::Colours::yellow);
+        g.fillRoundedRectangle(detectionMeterArea.withWidth(meterState.detectionWidth).toFloat(), 4.0f);
+    }
+
+    if (g.clipRegionIntersects(reductionMeterArea))
+    {
+        g.setColour(juce::Colours::red);
+        g.fillRoundedRectangle(reductionMeterArea.withWidth(meterState.reductionWidth).toFloat(), 4.0f);
+    }
+
+    // Reduction hangs from the top, newest at the right
+    if (!historyArea.isEmpty() && g.clipRegionIntersects(historyArea))
+    {
+        g.setColour(juce::Colours::red);
+        auto columns = std::min(HISTORY_LENGTH, historyArea.getWidth());
+        auto height = static_cast<float>(historyArea.getHeight());
+
+        for (int column = 0; column < columns; ++column)
+        {
+            auto value = reductionHistory[static_cast<size_t>((historyWrite - 1 - column + HISTORY_LENGTH) % HISTORY_LENGTH)];
+            auto depth = juce::roundToInt(value * height);
+
+            if (depth > 0)
+                g.fillRect(historyArea.getRight() - 1 - column, historyArea.getY(), 1, depth);
+        }
+    }
 
     // Show sensitivity value
-    g.setFont(10.0f);
-    g.setColour(juce::Colours::lightgrey);
-    float sensitivity = processorRef.threshold->get();
-    float detectionDb = (displayDetectionLevel > 0.00001f)
-        ? 20.0f * std::log10(displayDetectionLevel)
-        : -100.0f;
-    g.drawText("Sens: " + juce::String(sensitivity, 1) + "dB  Det: " + juce::String(detectionDb, 1) + "dB",
-               getLocalBounds().removeFromBottom(20), juce::Justification::centred);
+    if (g.clipRegionIntersects(statusArea))
+    {
+        g.setFont(10.0f);
+        g.setColour(juce::Colours::lightgrey);
+        g.drawText("Sens: " + juce::String(static_cast<float>(meterState.sensitivityTenths) / 10.0f, 1) + "dB"
+                       + "  Det: " + juce::String(static_cast<float>(meterState.detectionTenths) / 10.0f, 1) + "dB"
+                       + "  CPU: " + juce::String(static_cast<float>(meterState.cpuHundredths) / 100.0f, 2) + "%",
+                   statusArea, juce::Justification::centred);
+    }
+}
+
+void PlosiveRemoverEditor::showHistory(bool shouldShow)
+{
+    setSize(getWidth(), getHeight() + (shouldShow ? HISTORY_HEIGHT : -HISTORY_HEIGHT));
 }
 
 void PlosiveRemoverEditor::resized()
 {
     auto area = getLocalBounds().reduced(20);
-    area.removeFromTop(30);    // Space for title
-    area.removeFromBottom(80); // Space for meters
-
-    auto sliderWidth = area.getWidth() / 3;
+    auto titleRow = area.removeFromTop(30);
+    splitBandButton.setBounds(titleRow.removeFromRight(90));
+    spectralButton.setBounds(titleRow.removeFromRight(80));
+    linkBox.setBounds(titleRow.removeFromLeft(110).reduced(0, 3));
+    auto optionRow = area.removeFromTop(30);
+    repairFftBox.setBounds(optionRow.removeFromRight(80).reduced(0, 3));
+    repairButton.setBounds(optionRow.removeFromRight(90));
+    detectionFilterBox.setBounds(optionRow.removeFromLeft(110).reduced(0, 3));
+    historyButton.setBounds(optionRow.removeFromLeft(90).withTrimmedLeft(10));
+
+    for (auto& button : snapshotButtons)
+        button.setBounds(optionRow.removeFromLeft(28).reduced(2, 3));
+
+    // Meters at the bottom, with the status line under them
+    auto meterArea = area.removeFromBottom(80).removeFromBottom(60);
+    inputMeterArea = meterArea.removeFromLeft(meterArea.getWidth() / 3).reduced(5);
+    detectionMeterArea = meterArea.removeFromLeft(meterArea.getWidth() / 2).reduced(5);
+    reductionMeterArea = meterArea.reduced(5);
+    statusArea = getLocalBounds().removeFromBottom(20);
+
+    historyArea = historyButton.getToggleState() ? area.removeFromBottom(HISTORY_HEIGHT).reduced(5) : juce::Rectangle<int>();
+    background = {};
+
+    auto sliderWidth = area.getWidth() / 4;
 
     auto thresholdArea = area.removeFromLeft(sliderWidth);
     thresholdLabel.setBounds(thresholdArea.removeFromBottom(25));
@@ -163,6 +353,10 @@ void PlosiveRemoverEditor::resized()
     reductionLabel.setBounds(reductionArea.removeFromBottom(25));
     reductionSlider.setBounds(reductionArea);
 
-    frequencyLabel.setBounds(area.removeFromBottom(25));
-    frequencySlider.setBounds(area);
+    auto frequencyArea = area.removeFromLeft(sliderWidth);
+    frequencyLabel.setBounds(frequencyArea.removeFromBottom(25));
+    frequencySlider.setBounds(frequencyArea);
+
+    lookaheadLabel.setBounds(area.removeFromBottom(25));
+    lookaheadSlider.setBounds(area);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include <array>
 
 class PlosiveRemoverEditor : public juce::AudioProcessorEditor,
                               public juce::Timer
@@ -19,15 +20,74 @@ private:
     juce::Slider thresholdSlider;
     juce::Slider reductionSlider;
     juce::Slider frequencySlider;
+    juce::Slider lookaheadSlider;
 
     juce::Label thresholdLabel;
     juce::Label reductionLabel;
     juce::Label frequencyLabel;
+    juce::Label lookaheadLabel;
+
+    juce::ToggleButton splitBandButton{"Split band"};
+    juce::ToggleButton spectralButton{"Spectral"};
+    juce::ComboBox linkBox;   // detection link: linked / per channel / pairs / mid/side
+    juce::ToggleButton repairButton{"Repair"};
+    juce::ComboBox repairFftBox;  // repair FFT size
+    juce::ComboBox detectionFilterBox;  // detection low-pass: biquad / SVF
+    juce::ToggleButton historyButton{"History"};  // scrolling gain-reduction view
+    juce::TextButton snapshotButtons[PlosiveRemoverProcessor::NUM_SNAPSHOTS];  // A/B/C comparison
+
+    // Keep the controls and their parameters in sync, including host
+    // automation and undo. Declared after the controls they attach to.
+    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+    using ButtonAttachment = juce::AudioProcessorValueTreeState::ButtonAttachment;
+    using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+
+    std::unique_ptr<SliderAttachment> thresholdAttachment, reductionAttachment, frequencyAttachment, lookaheadAttachment;
+    std::unique_ptr<ButtonAttachment> splitBandAttachment, spectralAttachment, repairAttachment;
+    std::unique_ptr<ComboBoxAttachment> linkAttachment, repairFftAttachment, detectionFilterAttachment;
 
     // Meter values (smoothed for display)
-    float displayInputLevel = 0.0f;
+    float displayInputLevel = 0.0f;   // peak
+    float displayInputRms = 0.0f;
     float displayDetectionLevel = 0.0f;
     float displayGainReduction = 0.0f;
+    bool displayTriggered = false;    // detection meter turns orange while triggered
+
+    // This instance's processBlock time as a share of realtime
+    DspProfiler::LoadReading loadReading;
+    float displayCpuLoad = 0.0f;
+
+    // What the meters show, in pixels and in the status line's units. paint
+    // draws from this, and a timer tick only repaints the parts that changed.
+    struct MeterState
+    {
+        int inputPeakWidth = 0, inputRmsWidth = 0;
+        int detectionWidth = 0;
+        bool triggered = false;
+        int reductionWidth = 0;
+        int sensitivityTenths = 0, detectionTenths = 0, cpuHundredths = 0;  // status line
+    };
+
+    MeterState meterState;
+    MeterState computeMeterState() const;
+
+    // Layout, set in resized()
+    juce::Rectangle<int> inputMeterArea, detectionMeterArea, reductionMeterArea, statusArea, historyArea;
+
+    // Everything that doesn't move (background, panel, title, meter troughs
+    // and captions), rendered once per size and scale
+    juce::Image background;
+    float backgroundScale = 0.0f;
+    void drawBackground(juce::Graphics& g);
+
+    // Gain-reduction history: the deepest reduction of each timer tick,
+    // newest last. One column per tick, about 17 s at 30 Hz.
+    static constexpr int HISTORY_LENGTH = 512;
+    static constexpr int HISTORY_HEIGHT = 70;
+    std::array<float, HISTORY_LENGTH> reductionHistory{};
+    int historyWrite = 0;
+    int ticksSinceReduction = HISTORY_LENGTH + 1;  // the view is flat once this passes its columns
+    void showHistory(bool shouldShow);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlosiveRemoverEditor)
 };
@@ -1,27 +1,103 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Audit/RealtimeAudit.h"
 #include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+    // Adds a parameter to the layout and returns it; the value tree owns it
+    template <typename Parameter>
+    Parameter* addTo(juce::AudioProcessorValueTreeState::ParameterLayout& layout, std::unique_ptr<Parameter> parameter)
+    {
+        auto* raw = parameter.get();
+        layout.add(std::move(parameter));
+        return raw;
+    }
+
+    // Glide time for sensitivity, reduction and frequency automation
+    constexpr double PARAMETER_SMOOTHING_SECONDS = 0.05;
+
+    // Binary state, little-endian: magic, format version, parameter count,
+    // then per parameter its ID (length byte + UTF-8) and plain value as a
+    // float. Parameters are matched by ID, so ones added later load at their
+    // defaults and unknown ones are skipped.
+    constexpr int STATE_MAGIC = 0x56534c50;  // "PLSV"
+    constexpr int STATE_VERSION = 1;
+}
 
 PlosiveRemoverProcessor::PlosiveRemoverProcessor()
     : AudioProcessor(BusesProperties()
                      .withInput("Input", juce::AudioChannelSet::stereo(), true)
-                     .withOutput("Output", juce::AudioChannelSet::stereo(), true))
+                     .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+      parameters(*this, nullptr, "PlosiveRemoverState", createParameterLayout())
+{
+    for (auto* parameter : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            stateParameters.push_back(ranged);
+
+    jassert(stateParameters.size() <= static_cast<size_t>(MAX_STATE_PARAMETERS));
+
+    startTimerHz(20);
+}
+
+PlosiveRemoverProcessor::~PlosiveRemoverProcessor()
 {
-    addParameter(threshold = new juce::AudioParameterFloat(
+    stopTimer();
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout PlosiveRemoverProcessor::createParameterLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    threshold = addTo(layout, std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID("threshold", 1), "Sensitivity",
         juce::NormalisableRange<float>(0.0f, 24.0f, 0.1f), 6.0f));
 
-    addParameter(reduction = new juce::AudioParameterFloat(
+    reduction = addTo(layout, std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID("reduction", 1), "Reduction",
         juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f), 70.0f));
 
-    addParameter(frequency = new juce::AudioParameterFloat(
+    frequency = addTo(layout, std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID("frequency", 1), "Frequency",
         juce::NormalisableRange<float>(100.0f, 400.0f, 1.0f), 200.0f));
+
+    splitBand = addTo(layout, std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("splitband", 1), "Split Band", false));
+
+    lookahead = addTo(layout, std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("lookahead", 1), "Look-ahead",
+        juce::NormalisableRange<float>(MIN_LOOKAHEAD_MS, MAX_LOOKAHEAD_MS, 0.1f), 5.0f));
+
+    link = addTo(layout, std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("link", 1), "Detection Link",
+        juce::StringArray { "Linked", "Per channel", "Pairs", "Mid/Side" }, linked));
+
+    spectral = addTo(layout, std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("spectral", 1), "Spectral Detection", false));
+
+    repair = addTo(layout, std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("repair", 1), "Spectral Repair", false));
+
+    repairFftSize = addTo(layout, std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("repairfft", 1), "Repair FFT Size",
+        juce::StringArray { "256", "512", "1024", "2048" }, 1));
+
+    detectionFilter = addTo(layout, std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("detfilter", 1), "Detection Filter",
+        juce::StringArray { "Biquad", "SVF" }, 0));
+
+    return layout;
 }
 
-PlosiveRemoverProcessor::~PlosiveRemoverProcessor()
+void PlosiveRemoverProcessor::timerCallback()
 {
+    // Latency changes made by processBlock are reported from here, since
+    // notifying the host takes a lock
+    auto latency = pendingLatency.load();
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
 }
 
 const juce::String PlosiveRemoverProcessor::getName() const
@@ -36,7 +112,7 @@ bool PlosiveRemoverProcessor::isMidiEffect() const { return false; }
 double PlosiveRemoverProcessor::getTailLengthSeconds() const
 {
     // Report latency in seconds
-    return static_cast<double>(lookaheadSamples) / currentSampleRate;
+    return static_cast<double>(getLatencySamples()) / currentSampleRate;
 }
 
 int PlosiveRemoverProcessor::getNumPrograms() { return 1; }
@@ -45,114 +121,267 @@ void PlosiveRemoverProcessor::setCurrentProgram(int) {}
 const juce::String PlosiveRemoverProcessor::getProgramName(int) { return {}; }
 void PlosiveRemoverProcessor::changeProgramName(int, const juce::String&) {}
 
-void PlosiveRemoverProcessor::calculateBiquadLPF(BiquadFilter& filter, float cutoffHz, float q)
+void PlosiveRemoverProcessor::updateFilters(float cutoffHz, bool ramping)
 {
-    float w0 = 2.0f * juce::MathConstants<float>::pi * cutoffHz / static_cast<float>(currentSampleRate);
-    float cosw0 = std::cos(w0);
-    float sinw0 = std::sin(w0);
-    float alpha = sinw0 / (2.0f * q);
+    // Detection uses a wider bandwidth (1.5x the cutoff) to catch more of the plosive energy
+    float detectionCutoff = cutoffHz * 1.5f;
+
+    if (!ramping)
+    {
+        // Steady state: exact coefficients, recomputed only when the key changes
+        detector.setLowPass(detectionCutoff, 0.5f);
+        if (preparedForDouble)
+            crossoverDouble.setCutoff(cutoffHz, currentSampleRate);
+        else
+            crossover.setCutoff(cutoffHz, currentSampleRate);
+
+        spectralDetector.setLowBandCutoff(detectionCutoff);
+        spectralRepair.setCutoff(cutoffHz);
+        return;
+    }
+
+    float cosw0, sinw0;
+    trigTable.lookup(detectionCutoff, cosw0, sinw0);
+    detector.setLowPassCoefficients(cosw0, sinw0, 0.5f); // forces an exact update once the ramp ends
 
-    float a0 = 1.0f + alpha;
-    filter.b0 = ((1.0f - cosw0) / 2.0f) / a0;
-    filter.b1 = (1.0f - cosw0) / a0;
-    filter.b2 = filter.b0;
-    filter.a1 = (-2.0f * cosw0) / a0;
-    filter.a2 = (1.0f - alpha) / a0;
+    // The double crossover is for precision, so it takes exact (cached) trig
+    // rather than the table's float values
+    if (preparedForDouble)
+    {
+        crossoverDouble.setCutoff(cutoffHz, currentSampleRate);
+    }
+    else
+    {
+        trigTable.lookup(cutoffHz, cosw0, sinw0);
+        crossover.setCoefficients(cosw0, sinw0);
+    }
+
+    spectralDetector.setLowBandCutoff(detectionCutoff);
+    spectralRepair.setCutoff(cutoffHz);
+}
+
+bool PlosiveRemoverProcessor::isSmoothingParameters() const
+{
+    return smoothedThreshold.isSmoothing() || smoothedReduction.isSmoothing() || smoothedFrequency.isSmoothing();
+}
+
+PlosiveDetector::Filter PlosiveRemoverProcessor::getDetectionFilter() const
+{
+    return detectionFilter->getIndex() == 1 ? PlosiveDetector::Filter::svf : PlosiveDetector::Filter::biquad;
+}
+
+int PlosiveRemoverProcessor::getRepairOrder() const
+{
+    return SpectralRepair::MIN_ORDER + repairFftSize->getIndex();
 }
 
-void PlosiveRemoverProcessor::calculateBiquadHPF(BiquadFilter& filter, float cutoffHz, float q)
+int PlosiveRemoverProcessor::getAudioDelay(bool useRepair) const
 {
-    float w0 = 2.0f * juce::MathConstants<float>::pi * cutoffHz / static_cast<float>(currentSampleRate);
-    float cosw0 = std::cos(w0);
-    float sinw0 = std::sin(w0);
-    float alpha = sinw0 / (2.0f * q);
+    // The repair STFT already delays the audio by its FFT size; the delay
+    // line only adds whatever look-ahead that doesn't cover
+    if (useRepair)
+        return std::max(0, lookaheadSamples - spectralRepair.getLatencySamples());
 
-    float a0 = 1.0f + alpha;
-    filter.b0 = ((1.0f + cosw0) / 2.0f) / a0;
-    filter.b1 = (-(1.0f + cosw0)) / a0;
-    filter.b2 = filter.b0;
-    filter.a1 = (-2.0f * cosw0) / a0;
-    filter.a2 = (1.0f - alpha) / a0;
+    return lookaheadSamples;
+}
+
+void PlosiveRemoverProcessor::updateLatency(bool useRepair)
+{
+    pendingLatency.store(getAudioDelay(useRepair) + (useRepair ? spectralRepair.getLatencySamples() : 0));
 }
 
 void PlosiveRemoverProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
+    profiler.prepare(sampleRate);
+
+    maxChunkSize = std::max(1, samplesPerBlock);
 
-    // Look-ahead: ~5ms gives us time to react before the plosive hits
-    lookaheadSamples = static_cast<int>(sampleRate * 0.005);
-    lookaheadSamples = std::min(lookaheadSamples, MAX_LOOKAHEAD_SAMPLES);
+    // Look-ahead gives us time to react before the plosive hits. The delay line
+    // is sized for the longest setting at this sample rate, so the parameter
+    // can move without reallocating.
+    maxLookaheadSamples = static_cast<int>(std::ceil(sampleRate * MAX_LOOKAHEAD_MS / 1000.0));
+    lookaheadSamples = lookaheadMsToSamples(lookahead->get());
+
+    int numChannels = std::min(getTotalNumInputChannels(), MAX_CHANNELS);
+    numPreparedChannels = numChannels;
+    preparedForDouble = isUsingDoublePrecision();
+
+    if (preparedForDouble)
+    {
+        delayLineDouble.prepare(numChannels, maxLookaheadSamples, maxChunkSize);
+        delayLine.release();
+        conversionBuffer.setSize(numChannels, maxChunkSize);
+    }
+    else
+    {
+        delayLine.prepare(numChannels, maxLookaheadSamples, maxChunkSize);
+        delayLineDouble.release();
+        conversionBuffer.setSize(0, 0);
+    }
+
+    // Crossover state for split-band ducking
+    crossover.prepare(numChannels);
+    crossoverDouble.prepare(numChannels);
+
+    // Detector scratch covers MAX_CHANNELS units, so switching the link mode
+    // never allocates. Channel-to-unit tables for every mode are built up front.
+    detector.prepare(sampleRate, maxChunkSize);
+    buildChannelGroupings(getChannelLayoutOfBus(true, 0), numChannels);
+    activeLinkMode = link->getIndex();
+    detector.setNumUnits(groupings[activeLinkMode].numUnits);
+
+    eventTracker.prepare(sampleRate);
+    samplePosition = 0;
+    gainCacheKey = GainEnvelopeCache::CHAIN_START;
+    gainCacheChainValid = true;
+
+    // FFTs for every window size are created here; the look-ahead picks one
+    spectralDetector.prepare(sampleRate);
+    spectralDetector.setWindowForLookahead(lookaheadSamples);
+    spectralWasActive = false;
+
+    // STFT buffers for every channel at the largest FFT size
+    spectralRepair.prepare(sampleRate, numChannels);
+    spectralRepair.setOrder(getRepairOrder());
+    repairWasActive = repair->get();
 
     // Report latency to host
-    setLatencySamples(lookaheadSamples);
+    updateLatency(repairWasActive);
+    setLatencySamples(pendingLatency.load());
+
+    // Cutoff smoothing, plus a trig table spanning the crossover (100-400 Hz)
+    // and detection (1.5x) cutoffs
+    smoothedFrequency.reset(sampleRate, PARAMETER_SMOOTHING_SECONDS);
+    smoothedFrequency.setCurrentAndTargetValue(frequency->get());
+    smoothedThreshold.reset(sampleRate, PARAMETER_SMOOTHING_SECONDS);
+    smoothedThreshold.setCurrentAndTargetValue(threshold->get());
+    smoothedReduction.reset(sampleRate, PARAMETER_SMOOTHING_SECONDS);
+    smoothedReduction.setCurrentAndTargetValue(reduction->get() / 100.0f);
+    rampCellEnd = 0;
+    trigTable.prepare(sampleRate, 100.0f, 600.0f);
+    detector.setFilter(getDetectionFilter());
+    updateFilters(frequency->get(), false);
+}
 
-    // Initialize delay buffer for look-ahead
-    int numChannels = getTotalNumInputChannels();
-    delayBuffer.resize(static_cast<size_t>(numChannels));
-    for (auto& channel : delayBuffer)
+void PlosiveRemoverProcessor::buildChannelGroupings(const juce::AudioChannelSet& layout, int numChannels)
+{
+    numChannels = juce::jlimit(1, MAX_CHANNELS, numChannels);
+
+    auto& linkedGroup = groupings[linked];
+    auto& channelGroup = groupings[perChannel];
+    auto& pairGroup = groupings[pairs];
+
+    linkedGroup.numUnits = 1;
+
+    channelGroup.numUnits = numChannels;
+
+    for (int channel = 0; channel < numChannels; ++channel)
     {
-        channel.resize(static_cast<size_t>(MAX_LOOKAHEAD_SAMPLES), 0.0f);
+        linkedGroup.unitOfChannel[channel] = 0;
+        channelGroup.unitOfChannel[channel] = channel;
     }
-    delayWritePos = 0;
 
-    // Initialize per-channel HPFs for ducking (2 cascaded = 24dB/octave)
-    channelHPF1.resize(static_cast<size_t>(numChannels));
-    channelHPF2.resize(static_cast<size_t>(numChannels));
-    for (auto& hpf : channelHPF1) hpf.reset();
-    for (auto& hpf : channelHPF2) hpf.reset();
+    // Speaker pairs come from the channel types. Discrete layouts have no
+    // speaker positions, so neighbouring channels (1+2, 3+4, ...) are paired.
+    using CS = juce::AudioChannelSet;
+    static constexpr CS::ChannelType speakerPairs[][2] = {
+        { CS::left, CS::right },
+        { CS::leftCentre, CS::rightCentre },
+        { CS::leftSurround, CS::rightSurround },
+        { CS::leftSurroundSide, CS::rightSurroundSide },
+        { CS::leftSurroundRear, CS::rightSurroundRear },
+        { CS::wideLeft, CS::wideRight },
+        { CS::topFrontLeft, CS::topFrontRight },
+        { CS::topSideLeft, CS::topSideRight },
+        { CS::topRearLeft, CS::topRearRight },
+    };
 
-    // Reset detection filter
-    detectionLPF.reset();
-    calculateBiquadLPF(detectionLPF, frequency->get(), 0.707f);
+    auto partnerOf = [&](int channel) -> int
+    {
+        if (layout.size() != numChannels || layout.isDiscreteLayout())
+            return (channel ^ 1) < numChannels ? (channel ^ 1) : -1;
 
-    // Reset envelopes
-    fastEnvelope = 0.0f;
-    slowEnvelope = 0.0f;
+        auto type = layout.getTypeOfChannel(channel);
 
-    // Envelope time constants
-    // Fast: 1ms attack, 30ms release - catches transients
-    fastAttack = 1.0f - std::exp(-1.0f / (static_cast<float>(sampleRate) * 0.001f));
-    fastRelease = 1.0f - std::exp(-1.0f / (static_cast<float>(sampleRate) * 0.030f));
+        for (auto& pair : speakerPairs)
+        {
+            if (type == pair[0])
+                return layout.getChannelIndexForType(pair[1]);
 
-    // Slow: 20ms attack, 100ms release - tracks sustained content
-    slowAttack = 1.0f - std::exp(-1.0f / (static_cast<float>(sampleRate) * 0.020f));
-    slowRelease = 1.0f - std::exp(-1.0f / (static_cast<float>(sampleRate) * 0.100f));
+            if (type == pair[1])
+                return layout.getChannelIndexForType(pair[0]);
+        }
 
-    // Gain smoothing: ~3ms
-    gainSmoothCoeff = 1.0f - std::exp(-1.0f / (static_cast<float>(sampleRate) * 0.003f));
+        return -1;
+    };
 
-    // Average level tracking: ~500ms time constant for stable threshold
-    avgLevelCoeff = 1.0f - std::exp(-1.0f / (static_cast<float>(sampleRate) * 0.5f));
-    avgLevel = 0.0f;
+    pairGroup.numUnits = 0;
 
-    currentGainReduction = 1.0f;
-    targetGainReduction = 1.0f;
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto partner = partnerOf(channel);
+
+        // The first channel of a pair opens the unit, the second joins it
+        auto unit = (partner >= 0 && partner < channel) ? pairGroup.unitOfChannel[partner]
+                                                        : pairGroup.numUnits++;
+
+        pairGroup.unitOfChannel[channel] = unit;
+    }
+
+    // Mid/side: the same pairs, each opening a mid unit and the side unit after it
+    auto& midSideGroup = groupings[midSide];
+    midSideGroup.numUnits = 0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto partner = partnerOf(channel);
+        auto unit = (partner >= 0 && partner < channel) ? midSideGroup.unitOfChannel[partner] + 1
+                                                        : midSideGroup.numUnits;
+
+        if (unit == midSideGroup.numUnits)
+            midSideGroup.numUnits += partner >= 0 ? 2 : 1;
+
+        midSideGroup.unitOfChannel[channel] = unit;
+        midSideGroup.partnerOfChannel[channel] = partner;
+    }
 }
 
 void PlosiveRemoverProcessor::releaseResources()
 {
-    delayBuffer.clear();
-    channelHPF1.clear();
-    channelHPF2.clear();
+    delayLine.release();
+    delayLineDouble.release();
+    conversionBuffer.setSize(0, 0);
+    detector.release();
+    spectralDetector.release();
+    spectralRepair.release();
+    maxChunkSize = 0;
+    numPreparedChannels = 0;
 }
 
 bool PlosiveRemoverProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout from mono up to MAX_CHANNELS, including discrete and
+    // ambisonic ones, as long as input and output match
+    auto mainOutput = layouts.getMainOutputChannelSet();
+
+    if (mainOutput.isDisabled() || mainOutput.size() > MAX_CHANNELS)
         return false;
 
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+    if (mainOutput != layouts.getMainInputChannelSet())
         return false;
 
     return true;
 }
 
-void PlosiveRemoverProcessor::processBlock(juce::AudioBuffer<float>& buffer,
-                                            juce::MidiBuffer&)
+template <typename SampleType>
+void PlosiveRemoverProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer)
 {
+    constexpr bool isDouble = std::is_same_v<SampleType, double>;
+
     juce::ScopedNoDenormals noDenormals;
+    PLOSIVE_RT_AUDIT_SCOPE;
 
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -161,125 +390,532 @@ void PlosiveRemoverProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Get current parameter values
-    float thresholdDb = threshold->get();
-    float reductionAmount = reduction->get() / 100.0f;
-    float cutoffFreq = frequency->get();
+    // Hosts don't always call prepareToPlay before processing, or again after
+    // a layout change. Only channels with prepared state are processed; any
+    // others pass through.
+    numActiveChannels = std::min({ totalNumInputChannels, numPreparedChannels, buffer.getNumChannels() });
+
+    if (maxChunkSize == 0 || numActiveChannels == 0 || preparedForDouble != isDouble)
+        return;
+
+    auto blockStart = DspProfiler::now();
+    DspProfiler::StageTicks stageTicks {};
+
+    // Sensitivity, reduction and frequency glide to the values read here. A
+    // new value starts a fresh ramp cell at this block's first sample.
+    bool targetsChanged = threshold->get() != smoothedThreshold.getTargetValue()
+                       || reduction->get() / 100.0f != smoothedReduction.getTargetValue()
+                       || frequency->get() != smoothedFrequency.getTargetValue();
+
+    smoothedThreshold.setTargetValue(threshold->get());
+    smoothedReduction.setTargetValue(reduction->get() / 100.0f);
+    smoothedFrequency.setTargetValue(frequency->get());
 
-    // Update detection filter - use wider bandwidth for detection (1.5x the cutoff)
-    // This catches more of the plosive energy
-    calculateBiquadLPF(detectionLPF, cutoffFreq * 1.5f, 0.5f);
+    if (targetsChanged)
+        rampCellEnd = samplePosition;
+    detector.setFilter(getDetectionFilter());
 
-    // Update ducking HPF coefficients (cascaded for steeper slope)
-    for (size_t i = 0; i < channelHPF1.size(); ++i)
+    // A look-ahead change moves the read position and the reported latency.
+    // The ring already covers the maximum, so nothing is reallocated.
+    auto newLookahead = lookaheadMsToSamples(lookahead->get());
+    if (newLookahead != lookaheadSamples)
     {
-        calculateBiquadHPF(channelHPF1[i], cutoffFreq, 0.707f);
-        calculateBiquadHPF(channelHPF2[i], cutoffFreq, 0.707f);
+        lookaheadSamples = newLookahead;
+        spectralDetector.setWindowForLookahead(lookaheadSamples);
+    }
+
+    // Spectral repair takes over from the crossover. Switching it on, or
+    // changing its FFT size, starts from empty STFT buffers.
+    bool useRepair = repair->get();
+    if (useRepair && !repairWasActive)
+        spectralRepair.reset();
+
+    repairWasActive = useRepair;
+    spectralRepair.setOrder(getRepairOrder());
+    updateLatency(useRepair);
+
+    bool useSplitBand = splitBand->get() && !useRepair;
+    if (!useSplitBand)
+    {
+        // Start clean when the mode is switched back on, at either precision
+        crossover.reset();
+        crossoverDouble.reset();
+    }
+
+    // Units joining on a link change pick up the running state of unit 0.
+    // Open events belong to the old units, so they're closed first; so do
+    // those of a switch into or out of mid/side, which keeps the unit count.
+    auto linkMode = link->getIndex();
+    bool unitsChanged = detector.getNumUnits() != groupings[linkMode].numUnits
+                     || (linkMode == midSide) != (activeLinkMode == midSide);
+    activeLinkMode = linkMode;
+
+    if (unitsChanged)
+    {
+        eventTracker.flush(eventQueue);
+        detector.setNumUnits(groupings[activeLinkMode].numUnits);
+        spectralDetector.reset();
+    }
+
+    // Switching the spectral gate on starts a fresh analysis; switching it
+    // off hands full control back to the envelope detector
+    bool useSpectral = spectral->get();
+    if (useSpectral != spectralWasActive)
+    {
+        if (useSpectral)
+            spectralDetector.reset();
+        else
+            detector.clearGate();
+
+        spectralWasActive = useSpectral;
     }
 
     auto numSamples = buffer.getNumSamples();
+    auto maxChunk = maxChunkSize;
+    auto numDetectionUnits = detector.getNumUnits();
+    auto audioDelay = getAudioDelay(useRepair);
+
+    // Offline second pass: references come from the whole-file profile,
+    // changing once per profile hop
+    bool useLevelProfile = levelProfile != nullptr && levelProfile->isFinished() && isNonRealtime()
+                        && levelProfile->getNumUnits() == numDetectionUnits;
+
+    if (!useLevelProfile)
+        detector.releaseAverageLevels();
+
+    // Replaying cached detection needs the excess alone to decide the gains
+    gainCacheChainValid = gainCacheChainValid && gainCacheEnabled.load() && isNonRealtime()
+                       && !useSpectral && !useLevelProfile;
 
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Input metering covers every sample of every channel before processing
+    MeterFrame meterFrame;
+    meterFrame.numChannels = numActiveChannels;
+    meterFrame.numSamples = numSamples;
+
+    for (int channel = 0; channel < meterFrame.numChannels; ++channel)
+    {
+        meterFrame.peak[channel] = static_cast<float>(buffer.getMagnitude(channel, 0, numSamples));
+        meterFrame.rms[channel] = static_cast<float>(buffer.getRMSLevel(channel, 0, numSamples));
+    }
+
+    // Sub-blocks may end early, so the loop advances by whatever was
+    // actually processed
+    int chunk = 0;
+
+    for (int start = 0; start < numSamples; start += chunk)
     {
-        // Sum input for detection (mono sum)
-        float inputSum = 0.0f;
-        for (int channel = 0; channel < totalNumInputChannels; ++channel)
+        chunk = std::min(maxChunk, numSamples - start);
+
+        // While a parameter glides, work in cells that end on a fixed grid
+        // of stream positions and step the ramps once per cell. A host block
+        // or profile hop that ends mid-cell keeps the cell's values, so a
+        // ramp is rendered the same at any buffer size. Coefficients are
+        // only refreshed while the cutoff moves.
+        if (samplePosition >= rampCellEnd)
+        {
+            if (isSmoothingParameters())
+            {
+                auto cellLength = PARAMETER_UPDATE_INTERVAL - static_cast<int>(samplePosition % PARAMETER_UPDATE_INTERVAL);
+                rampCellEnd = samplePosition + cellLength;
+                rampFrequencyMoving = smoothedFrequency.isSmoothing();
+                rampThreshold = smoothedThreshold.isSmoothing() ? smoothedThreshold.skip(cellLength)
+                                                                : smoothedThreshold.getTargetValue();
+                rampReduction = smoothedReduction.isSmoothing() ? smoothedReduction.skip(cellLength)
+                                                                : smoothedReduction.getTargetValue();
+                rampFrequency = rampFrequencyMoving ? smoothedFrequency.skip(cellLength)
+                                                    : smoothedFrequency.getTargetValue();
+            }
+            else
+            {
+                rampFrequencyMoving = false;
+                rampThreshold = smoothedThreshold.getTargetValue();
+                rampReduction = smoothedReduction.getTargetValue();
+                rampFrequency = smoothedFrequency.getTargetValue();
+            }
+        }
+
+        if (samplePosition < rampCellEnd)
+            chunk = std::min(chunk, static_cast<int>(rampCellEnd - samplePosition));
+
+        if (useLevelProfile)
         {
-            inputSum += buffer.getReadPointer(channel)[sample];
+            auto hopSize = levelProfile->getHopSize();
+            chunk = std::min(chunk, hopSize - static_cast<int>(samplePosition % hopSize));
+
+            float averageLevels[PlosiveDetector::MAX_UNITS];
+            for (int unit = 0; unit < numDetectionUnits; ++unit)
+                averageLevels[unit] = levelProfile->getLevel(unit, samplePosition);
+
+            detector.setAverageLevels(averageLevels);
         }
-        inputSum /= static_cast<float>(totalNumInputChannels);
 
-        // Low-pass filter to isolate plosive frequencies
-        float lowFreqContent = detectionLPF.process(inputSum);
-        float lowFreqAbs = std::abs(lowFreqContent);
+        float thresholdDb = rampThreshold;
+        float reductionAmount = rampReduction;
+        float frequencyHz = rampFrequency;
+        updateFilters(frequencyHz, rampFrequencyMoving);
 
-        // Fast envelope (catches transients) - 0.5ms attack
-        if (lowFreqAbs > fastEnvelope)
-            fastEnvelope += fastAttack * (lowFreqAbs - fastEnvelope);
+        auto detectionStart = DspProfiler::now();
+        if constexpr (isDouble)
+        {
+            copyToConversionBuffer(buffer, start, chunk);
+            mixDetectionInput(conversionBuffer, 0, chunk);
+        }
         else
-            fastEnvelope += fastRelease * (lowFreqAbs - fastEnvelope);
+        {
+            mixDetectionInput(buffer, start, chunk);
+        }
 
-        // Slow envelope (tracks sustained content) - 50ms attack
-        if (lowFreqAbs > slowEnvelope)
-            slowEnvelope += slowAttack * (lowFreqAbs - slowEnvelope);
+        if (useSpectral)
+            spectralDetector.process(detector.getInputBuffer(), detector.getGateBuffer(), numDetectionUnits, chunk);
+
+        auto envelopeStart = DspProfiler::now();
+        if (gainCacheChainValid)
+            detectWithCache(chunk, thresholdDb, reductionAmount, frequencyHz);
         else
-            slowEnvelope += slowRelease * (lowFreqAbs - slowEnvelope);
+            detector.process(chunk, thresholdDb, reductionAmount, detectorMode.load());
+        auto envelopeEnd = DspProfiler::now();
 
-        // Track average low-frequency level (slow follower for stable reference)
-        avgLevel += avgLevelCoeff * (lowFreqAbs - avgLevel);
+        eventTracker.process(detector, chunk, samplePosition, eventQueue);
+        samplePosition += chunk;
 
-        // Convert to dB
-        float envelopeDb = (fastEnvelope > 0.00001f)
-            ? 20.0f * std::log10(fastEnvelope)
-            : -100.0f;
+        for (int unit = 0; unit < numDetectionUnits; ++unit)
+            meterFrame.minGain = std::min(meterFrame.minGain,
+                                          juce::FloatVectorOperations::findMinimum(detector.getGains(unit), chunk));
 
-        float avgLevelDb = (avgLevel > 0.00001f)
-            ? 20.0f * std::log10(avgLevel)
-            : -100.0f;
+        auto delayStart = DspProfiler::now();
+        if constexpr (isDouble)
+            delayLineDouble.process(buffer, start, chunk, numActiveChannels, audioDelay);
+        else
+            delayLine.process(buffer, start, chunk, numActiveChannels, audioDelay);
 
-        // Sensitivity control: how many dB above average to trigger
-        // Higher sensitivity value = triggers on smaller spikes (more sensitive)
-        // sensitivity=24 means trigger when 0dB above average (very sensitive)
-        // sensitivity=0 means trigger when 24dB above average (not sensitive)
-        float triggerThresholdDb = avgLevelDb + (24.0f - thresholdDb);
+        auto applyStart = DspProfiler::now();
+        applyGain(buffer, start, chunk, useSplitBand, useRepair);
+        auto applyEnd = DspProfiler::now();
 
-        // Calculate target gain reduction
-        targetGainReduction = 1.0f;
+        stageTicks[DspProfiler::detection] += envelopeStart - detectionStart;
+        stageTicks[DspProfiler::envelopeAndGain] += envelopeEnd - envelopeStart;
+        stageTicks[DspProfiler::delay] += applyStart - delayStart;
+        stageTicks[DspProfiler::apply] += applyEnd - applyStart;
+    }
+
+    // Detector state across units: the hottest envelope, and whether any is triggered
+    for (int unit = 0; unit < numDetectionUnits; ++unit)
+    {
+        meterFrame.envelope = std::max(meterFrame.envelope, detector.getEnvelope(unit));
+        meterFrame.triggered = meterFrame.triggered || detector.isTriggered(unit);
+    }
+
+    meterFifo.push(meterFrame);
+
+    stageTicks[DspProfiler::block] = DspProfiler::now() - blockStart;
+    profiler.record(stageTicks, numSamples);
+}
+
+void PlosiveRemoverProcessor::detectWithCache(int numSamples, float thresholdDb, float reductionAmount, float cutoffHz)
+{
+    auto mode = detectorMode.load();
+    auto numUnits = detector.getNumUnits();
 
-        // Trigger when fast envelope exceeds threshold
-        // Must also exceed absolute minimum to avoid triggering on silence
-        bool hasEnergy = (envelopeDb > triggerThresholdDb) && (envelopeDb > -40.0f);
+    // Everything but the input that decides the excess. Reduction isn't
+    // among them: replayGains applies it.
+    const float settings[] = { thresholdDb, cutoffHz,
+                               static_cast<float>(static_cast<int>(mode)),
+                               static_cast<float>(static_cast<int>(detector.getFilter())),
+                               static_cast<float>(activeLinkMode),
+                               static_cast<float>(currentSampleRate) };
 
-        if (hasEnergy)
+    gainCacheKey = GainEnvelopeCache::keyFor(gainCacheKey, settings, juce::numElementsInArray(settings),
+                                             detector.getInputBuffer(), numSamples, numUnits);
+
+    PlosiveDetector::DetectionState state;
+
+    if (gainCache.find(gainCacheKey, numSamples, numUnits, detector.getExcessBuffer(), state))
+    {
+        detector.restoreDetectionState(state);
+        detector.replayGains(numSamples, reductionAmount);
+        return;
+    }
+
+    detector.process(numSamples, thresholdDb, reductionAmount, mode);
+    detector.saveDetectionState(state);
+    gainCache.store(gainCacheKey, detector.getExcessDb(), numSamples, numUnits, state);
+}
+
+void PlosiveRemoverProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    processSamples(buffer);
+}
+
+void PlosiveRemoverProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    processSamples(buffer);
+}
+
+void PlosiveRemoverProcessor::copyToConversionBuffer(const juce::AudioBuffer<double>& buffer, int startSample, int numSamples)
+{
+    for (int channel = 0; channel < numActiveChannels; ++channel)
+    {
+        const auto* src = buffer.getReadPointer(channel, startSample);
+        auto* dest = conversionBuffer.getWritePointer(channel);
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = static_cast<float>(src[i]);
+    }
+}
+
+void PlosiveRemoverProcessor::copyFromConversionBuffer(juce::AudioBuffer<double>& buffer, int startSample, int numSamples) const
+{
+    for (int channel = 0; channel < numActiveChannels; ++channel)
+    {
+        const auto* src = conversionBuffer.getReadPointer(channel);
+        auto* dest = buffer.getWritePointer(channel, startSample);
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = static_cast<double>(src[i]);
+    }
+}
+
+void PlosiveRemoverProcessor::mixDetectionInput(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    auto numChannels = numActiveChannels;
+    auto& grouping = groupings[activeLinkMode];
+    auto numUnits = grouping.numUnits;
+    auto* input = detector.getInputBuffer();
+
+    if (numUnits == 1)
+    {
+        juce::FloatVectorOperations::copy(input, buffer.getReadPointer(0, startSample), numSamples);
+
+        for (int channel = 1; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::add(input, buffer.getReadPointer(channel, startSample), numSamples);
+
+        // Exact for mono and stereo, so the result matches dividing the sum per sample
+        if (numChannels > 1)
+            juce::FloatVectorOperations::multiply(input, 1.0f / static_cast<float>(numChannels), numSamples);
+
+        return;
+    }
+
+    // Mid/side: half the sum and half the difference of each pair. A channel
+    // whose partner this block doesn't have runs alone, and the units of
+    // missing channels read silence.
+    if (activeLinkMode == midSide)
+    {
+        if (numChannels < numPreparedChannels)
+            juce::FloatVectorOperations::clear(input, numSamples * numUnits);
+
+        for (int channel = 0; channel < numChannels; ++channel)
         {
-            // Proportional reduction based on how much we exceed threshold
-            float excessDb = envelopeDb - triggerThresholdDb;
-            float ratio = std::min(1.0f, excessDb / 6.0f);  // Full reduction at 6dB over threshold
-            targetGainReduction = 1.0f - (reductionAmount * ratio);
-            targetGainReduction = std::max(0.05f, targetGainReduction);
-        }
+            auto partner = grouping.partnerOfChannel[channel];
+            const auto* first = buffer.getReadPointer(channel, startSample);
+            auto* mid = input + grouping.unitOfChannel[channel];
+
+            if (partner < 0 || partner >= numChannels)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    mid[i * numUnits] = first[i];
+            }
+            else if (partner > channel)
+            {
+                const auto* second = buffer.getReadPointer(partner, startSample);
+                auto* side = input + grouping.unitOfChannel[partner];
 
-        // Smooth gain changes with separate attack/release
-        // Faster attack to catch plosive, slower release to avoid clicks on recovery
-        if (targetGainReduction < currentGainReduction) {
-            // Attack: reduce gain quickly (but not instant)
-            currentGainReduction += gainSmoothCoeff * 2.0f * (targetGainReduction - currentGainReduction);
-        } else {
-            // Release: restore gain slowly to avoid click
-            currentGainReduction += gainSmoothCoeff * 0.3f * (targetGainReduction - currentGainReduction);
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    mid[i * numUnits] = (first[i] + second[i]) * 0.5f;
+                    side[i * numUnits] = (first[i] - second[i]) * 0.5f;
+                }
+            }
         }
 
-        // Process each channel with look-ahead
-        for (int channel = 0; channel < totalNumInputChannels; ++channel)
-        {
-            auto* channelData = buffer.getWritePointer(channel);
-            auto& delay = delayBuffer[static_cast<size_t>(channel)];
+        return;
+    }
+
+    // Several units: accumulate each channel into its unit's lane of the
+    // interleaved detector input, then average the paired lanes. The counts
+    // come from the channels this block actually has, which can be fewer
+    // than the groupings were built for.
+    juce::FloatVectorOperations::clear(input, numSamples * numUnits);
+    int channelsInUnit[MAX_CHANNELS] = {};
+    bool anyPaired = false;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto unit = grouping.unitOfChannel[channel];
+        const auto* src = buffer.getReadPointer(channel, startSample);
+        auto* dest = input + unit;
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i * numUnits] += src[i];
 
-            // Read from delay buffer (look-ahead)
-            int readPos = (delayWritePos - lookaheadSamples + MAX_LOOKAHEAD_SAMPLES) % MAX_LOOKAHEAD_SAMPLES;
-            float delayedSample = delay[static_cast<size_t>(readPos)];
+        anyPaired = anyPaired || ++channelsInUnit[unit] > 1;
+    }
+
+    if (!anyPaired)
+        return; // one channel per unit, nothing to average
+
+    float unitScale[MAX_CHANNELS];
+    for (int unit = 0; unit < numUnits; ++unit)
+        unitScale[unit] = channelsInUnit[unit] > 1 ? 1.0f / static_cast<float>(channelsInUnit[unit]) : 1.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+        for (int unit = 0; unit < numUnits; ++unit)
+            input[i * numUnits + unit] *= unitScale[unit];
+}
+
+void PlosiveRemoverProcessor::analyseGainCurve(const float* monoInput, float* gainOut, int numSamples)
+{
+    float thresholdDb = threshold->get();
+    float reductionAmount = reduction->get() / 100.0f;
+    auto maxChunk = maxChunkSize;
 
-            // Write current sample to delay buffer
-            delay[static_cast<size_t>(delayWritePos)] = channelData[sample];
+    detector.setFilter(getDetectionFilter());
+    updateFilters(frequency->get(), false);
+    detector.setNumUnits(1);
 
-            // Apply gain reduction with soft knee
-            // Use squared gain for smoother perceived volume change
-            float smoothGain = currentGainReduction * currentGainReduction;
-            smoothGain = smoothGain * 0.5f + currentGainReduction * 0.5f; // Blend linear and squared
+    for (int start = 0; start < numSamples && maxChunk > 0; start += maxChunk)
+    {
+        auto chunk = std::min(maxChunk, numSamples - start);
+
+        juce::FloatVectorOperations::copy(detector.getInputBuffer(), monoInput + start, chunk);
+        detector.process(chunk, thresholdDb, reductionAmount, detectorMode.load());
+        juce::FloatVectorOperations::copy(gainOut + start, detector.getGains(0), chunk);
+    }
+}
+
+void PlosiveRemoverProcessor::beginLevelAnalysis(LoudnessProfile& profile, juce::int64 expectedLength)
+{
+    activeLinkMode = link->getIndex();
+    profile.prepare(currentSampleRate, groupings[activeLinkMode].numUnits, getDetectionFilter(), frequency->get() * 1.5f,
+                    expectedLength);
+}
+
+void PlosiveRemoverProcessor::analyseLevels(const juce::AudioBuffer<float>& buffer, int numSamples, LoudnessProfile& profile)
+{
+    // The detector's input buffer is only scratch here; its state is untouched
+    numActiveChannels = std::min({ getTotalNumInputChannels(), numPreparedChannels, buffer.getNumChannels() });
+    activeLinkMode = link->getIndex();
 
-            float outputSample = delayedSample * smoothGain;
+    if (maxChunkSize == 0 || numActiveChannels == 0)
+        return;
 
-            channelData[sample] = outputSample;
+    for (int start = 0; start < numSamples; start += maxChunkSize)
+    {
+        auto chunk = std::min(maxChunkSize, numSamples - start);
+        mixDetectionInput(buffer, start, chunk);
+        profile.addBlock(detector.getInputBuffer(), chunk);
+    }
+}
+
+int PlosiveRemoverProcessor::lookaheadMsToSamples(float ms) const
+{
+    auto samples = static_cast<int>(currentSampleRate * static_cast<double>(ms) / 1000.0);
+    return std::min(samples, maxLookaheadSamples);
+}
+
+template <typename SampleType>
+void PlosiveRemoverProcessor::applyGain(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples,
+                                        bool useSplitBand, bool useRepair)
+{
+    auto numChannels = numActiveChannels;
+    auto& grouping = groupings[activeLinkMode];
+
+    const float* channelGains[MAX_CHANNELS];
+    for (int channel = 0; channel < numChannels; ++channel)
+        channelGains[channel] = detector.getGains(grouping.unitOfChannel[channel]);
+
+    // In mid/side mode the gain stage runs on mid and side: the first channel
+    // of each pair carries mid and gets the mid gains, the second side. On
+    // the broadband path, idle pairs skip the round trip and pass untouched.
+    bool useMidSide = activeLinkMode == midSide;
+    bool skipIdlePairs = !useRepair && !useSplitBand;
+
+    if (useMidSide)
+        convertMidSide(buffer, startSample, numSamples, true, skipIdlePairs);
+
+    if (useRepair)
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+        {
+            copyToConversionBuffer(buffer, startSample, numSamples);
+            spectralRepair.process(conversionBuffer, 0, numSamples, numChannels, channelGains);
+            copyFromConversionBuffer(buffer, startSample, numSamples);
+        }
+        else
+        {
+            spectralRepair.process(buffer, startSample, numSamples, numChannels, channelGains);
         }
+    }
+    else if (useSplitBand)
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            crossoverDouble.process(buffer, startSample, numSamples, numChannels, channelGains);
+        else
+            crossover.process(buffer, startSample, numSamples, numChannels, channelGains);
+    }
+    else
+    {
+        // Gains of exactly 1 (a detector that's been idle since reset) change nothing
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            if (detector.hasUnityGain(grouping.unitOfChannel[channel]))
+                continue;
+
+            auto* data = buffer.getWritePointer(channel, startSample);
 
-        // Advance delay write position
-        delayWritePos = (delayWritePos + 1) % MAX_LOOKAHEAD_SAMPLES;
+            if constexpr (std::is_same_v<SampleType, double>)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] *= static_cast<double>(channelGains[channel][i]);
+            }
+            else
+            {
+                juce::FloatVectorOperations::multiply(data, channelGains[channel], numSamples);
+            }
+        }
     }
 
-    // Update meters (once per block for efficiency)
-    meterInputLevel.store(std::abs(buffer.getSample(0, numSamples / 2)));
-    meterDetectionLevel.store(fastEnvelope);
-    meterGainReduction.store(1.0f - currentGainReduction);
+    if (useMidSide)
+        convertMidSide(buffer, startSample, numSamples, false, skipIdlePairs);
+}
+
+template <typename SampleType>
+void PlosiveRemoverProcessor::convertMidSide(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples,
+                                             bool toMidSide, bool skipIdlePairs)
+{
+    auto& grouping = groupings[midSide];
+
+    for (int channel = 0; channel < numActiveChannels; ++channel)
+    {
+        auto partner = grouping.partnerOfChannel[channel];
+
+        // Each pair once, from its first channel; a partner this block
+        // doesn't have leaves the channel unpaired
+        if (partner <= channel || partner >= numActiveChannels)
+            continue;
+
+        if (skipIdlePairs && detector.hasUnityGain(grouping.unitOfChannel[channel])
+                          && detector.hasUnityGain(grouping.unitOfChannel[partner]))
+            continue;
+
+        auto* first = buffer.getWritePointer(channel, startSample);
+        auto* second = buffer.getWritePointer(partner, startSample);
+
+        if (toMidSide)
+        {
+            // second = (L - R) / 2 = S, then first = L - S = M
+            juce::FloatVectorOperations::subtract(second, first, second, numSamples);
+            juce::FloatVectorOperations::multiply(second, static_cast<SampleType>(0.5), numSamples);
+            juce::FloatVectorOperations::subtract(first, second, numSamples);
+        }
+        else
+        {
+            // first = M + S = L, then second = L - 2S = M - S = R
+            juce::FloatVectorOperations::add(first, second, numSamples);
+            juce::FloatVectorOperations::multiply(second, static_cast<SampleType>(-2), numSamples);
+            juce::FloatVectorOperations::add(second, first, numSamples);
+        }
+    }
 }
 
 bool PlosiveRemoverProcessor::hasEditor() const
@@ -292,28 +928,147 @@ juce::AudioProcessorEditor* PlosiveRemoverProcessor::createEditor()
     return new PlosiveRemoverEditor(*this);
 }
 
+void PlosiveRemoverProcessor::captureParameters(float* values) const
+{
+    for (size_t i = 0; i < stateParameters.size(); ++i)
+        values[i] = stateParameters[i]->convertFrom0to1(stateParameters[i]->getValue());
+}
+
+void PlosiveRemoverProcessor::applyParameters(const float* values)
+{
+    for (size_t i = 0; i < stateParameters.size(); ++i)
+    {
+        auto* parameter = stateParameters[i];
+        auto value = parameter->convertTo0to1(values[i]);
+
+        if (value != parameter->getValue())
+            parameter->setValueNotifyingHost(value);
+    }
+}
+
 void PlosiveRemoverProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = juce::ValueTree("PlosiveRemoverState");
-    state.setProperty("threshold", threshold->get(), nullptr);
-    state.setProperty("reduction", reduction->get(), nullptr);
-    state.setProperty("frequency", frequency->get(), nullptr);
+    float values[MAX_STATE_PARAMETERS];
+    captureParameters(values);
+
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(STATE_MAGIC);
+    stream.writeInt(STATE_VERSION);
+    stream.writeInt(static_cast<int>(stateParameters.size()));
+
+    for (size_t i = 0; i < stateParameters.size(); ++i)
+    {
+        auto id = stateParameters[i]->getParameterID();
+        auto length = static_cast<int>(id.getNumBytesAsUTF8());
 
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+        stream.writeByte(static_cast<char>(length));
+        stream.write(id.toRawUTF8(), static_cast<size_t>(length));
+        stream.writeFloat(values[i]);
+    }
 }
 
 void PlosiveRemoverProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    if (!readBinaryState(data, sizeInBytes))
+        readLegacyState(data, sizeInBytes);
+}
+
+bool PlosiveRemoverProcessor::readBinaryState(const void* data, int sizeInBytes)
+{
+    if (data == nullptr || sizeInBytes < 12)
+        return false;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+
+    if (stream.readInt() != STATE_MAGIC)
+        return false;
+
+    // A newer format than this build knows: keep the current settings
+    // rather than guess
+    if (stream.readInt() != STATE_VERSION)
+        return true;
+
+    // Parameters missing from the state go back to their defaults
+    float values[MAX_STATE_PARAMETERS];
+    for (size_t i = 0; i < stateParameters.size(); ++i)
+        values[i] = stateParameters[i]->convertFrom0to1(stateParameters[i]->getDefaultValue());
+
+    auto count = stream.readInt();
+    char id[256];
+
+    for (int entry = 0; entry < count; ++entry)
+    {
+        auto length = static_cast<int>(static_cast<juce::uint8>(stream.readByte()));
+
+        if (stream.getNumBytesRemaining() < length + 4)
+            return true;  // truncated: apply nothing
+
+        stream.read(id, length);
+        auto value = stream.readFloat();
+
+        // IDs are compared as bytes, so an entry costs no String of its own
+        for (size_t i = 0; i < stateParameters.size(); ++i)
+        {
+            auto parameterId = stateParameters[i]->getParameterID();
+
+            if (static_cast<int>(parameterId.getNumBytesAsUTF8()) == length
+                && std::memcmp(parameterId.toRawUTF8(), id, static_cast<size_t>(length)) == 0)
+            {
+                values[i] = value;
+                break;
+            }
+        }
+    }
+
+    applyParameters(values);
+    return true;
+}
+
+void PlosiveRemoverProcessor::readLegacyState(const void* data, int sizeInBytes)
 {
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
-    if (xmlState != nullptr && xmlState->hasTagName("PlosiveRemoverState"))
+    if (xmlState == nullptr || !xmlState->hasTagName("PlosiveRemoverState"))
+        return;
+
+    auto state = juce::ValueTree::fromXml(*xmlState);
+
+    // Saved as the parameter tree
+    if (state.getChildWithName("PARAM").isValid())
     {
-        auto state = juce::ValueTree::fromXml(*xmlState);
-        *threshold = static_cast<float>(state.getProperty("threshold", -30.0f));
-        *reduction = static_cast<float>(state.getProperty("reduction", 70.0f));
-        *frequency = static_cast<float>(state.getProperty("frequency", 150.0f));
+        parameters.replaceState(state);
+        return;
     }
+
+    // Saved before the parameter tree: one property per parameter. Missing
+    // properties take the parameter defaults.
+    *threshold = static_cast<float>(state.getProperty("threshold", 6.0f));
+    *reduction = static_cast<float>(state.getProperty("reduction", 70.0f));
+    *frequency = static_cast<float>(state.getProperty("frequency", 200.0f));
+    *splitBand = static_cast<bool>(state.getProperty("splitband", false));
+    *lookahead = static_cast<float>(state.getProperty("lookahead", 5.0f));
+    *link = static_cast<int>(state.getProperty("link", static_cast<int>(linked)));
+    *spectral = static_cast<bool>(state.getProperty("spectral", false));
+    *repair = static_cast<bool>(state.getProperty("repair", false));
+    *repairFftSize = static_cast<int>(state.getProperty("repairfft", 1));
+    *detectionFilter = static_cast<int>(state.getProperty("detfilter", 0));
+}
+
+void PlosiveRemoverProcessor::selectSnapshot(int slot)
+{
+    slot = juce::jlimit(0, NUM_SNAPSHOTS - 1, slot);
+
+    if (slot == activeSnapshot)
+        return;
+
+    auto& leaving = snapshots[activeSnapshot];
+    captureParameters(leaving.values);
+    leaving.isValid = true;
+
+    if (snapshots[slot].isValid)
+        applyParameters(snapshots[slot].values);
+
+    activeSnapshot = slot;
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -1,10 +1,22 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "BiquadTrigTable.h"
+#include "DspProfiler.h"
+#include "GainEnvelopeCache.h"
+#include "LinkwitzRileyCrossover.h"
+#include "LookaheadDelayLine.h"
+#include "LoudnessProfile.h"
+#include "MeterFifo.h"
+#include "PlosiveDetector.h"
+#include "PlosiveEvents.h"
+#include "SpectralDetector.h"
+#include "SpectralRepair.h"
 #include <vector>
 #include <atomic>
 
-class PlosiveRemoverProcessor : public juce::AudioProcessor
+class PlosiveRemoverProcessor : public juce::AudioProcessor,
+                                private juce::Timer
 {
 public:
     PlosiveRemoverProcessor();
@@ -16,6 +28,13 @@ public:
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // In double precision the audio path (delay, gain, split-band crossover)
+    // runs in double. Detection works on a float copy of its input, and
+    // spectral repair on float copies of the delayed audio, since its FFT is
+    // single precision.
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -33,77 +52,239 @@ public:
     const juce::String getProgramName(int index) override;
     void changeProgramName(int index, const juce::String& newName) override;
 
+    // State is a small binary record (see the format in PluginProcessor.cpp).
+    // States saved as XML by earlier versions still load.
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    // Parameters exposed for the UI
+    // A/B/C comparison: each slot keeps its own settings while another one is
+    // active. Selecting a slot stores the current settings in the active slot
+    // and recalls the new one; a slot never visited starts from the current
+    // settings. Message thread only: the audio thread just sees parameters
+    // change, and glides sensitivity, reduction and frequency as for automation.
+    static constexpr int NUM_SNAPSHOTS = 3;
+    void selectSnapshot(int slot);
+    int getActiveSnapshot() const { return activeSnapshot; }
+
+    // Owns the parameters below; the editor attaches its controls to it
+    juce::AudioProcessorValueTreeState parameters;
+
+    // Parameters exposed for the UI and the command-line tools
     juce::AudioParameterFloat* threshold;
     juce::AudioParameterFloat* reduction;
     juce::AudioParameterFloat* frequency;
+    juce::AudioParameterBool* splitBand;   // duck only the band below `frequency`
+    juce::AudioParameterFloat* lookahead;  // ms; the reported latency unless spectral repair needs more
+    juce::AudioParameterChoice* link;      // how channels share detection, see LinkMode
+    juce::AudioParameterBool* spectral;    // gate detection with the FFT analysis in SpectralDetector
+    juce::AudioParameterBool* repair;      // reduce only the bins below `frequency` (SpectralRepair); overrides split band
+    juce::AudioParameterChoice* repairFftSize;  // 256-2048; larger sizes resolve the low end better but add latency
+    juce::AudioParameterChoice* detectionFilter;  // detection low-pass topology, see PlosiveDetector::Filter
+
+    // Linked: one detector on the average of all channels (the original behaviour).
+    // Per channel: every channel ducks on its own. Pairs: left/right-style speaker
+    // pairs share a detector, unpaired channels (centre, LFE, ...) run alone.
+    // Mid/side: each pair is detected and ducked as mid and side, so an
+    // off-axis pop only takes down the side; unpaired channels run alone.
+    enum LinkMode { linked = 0, perChannel, pairs, midSide, numLinkModes };
+
+    static constexpr int MAX_CHANNELS = PlosiveDetector::MAX_UNITS;
+    static_assert(MAX_CHANNELS <= MeterFrame::MAX_CHANNELS, "meter frames must cover every channel");
+
+    static constexpr float MIN_LOOKAHEAD_MS = 1.0f;
+    static constexpr float MAX_LOOKAHEAD_MS = 20.0f;
+
+    // For metering in UI: one frame per processed block, drained by the editor
+    MeterFifo meterFifo;
+
+    // Per-stage processBlock timing since the last prepareToPlay. Readable
+    // from any thread: getLoad for CPU use, toJson for the full histograms.
+    DspProfiler profiler;
+
+    // Detected plosives, pushed from processBlock as each one ends. Drain from
+    // a single consumer thread; positions count from the last prepareToPlay.
+    PlosiveEventQueue eventQueue;
+
+    // Pushes events that are still open. For offline rendering, after the
+    // last processBlock call and from the same thread.
+    void flushEvents() { eventTracker.flush(eventQueue); }
 
-    // For metering in UI (atomic for thread safety)
-    std::atomic<float> meterGainReduction{0.0f};
-    std::atomic<float> meterInputLevel{0.0f};
-    std::atomic<float> meterDetectionLevel{0.0f};
+    // Detector implementations, see PlosiveDetector::Mode
+    using DetectorMode = PlosiveDetector::Mode;
+    void setDetectorMode(DetectorMode mode) { detectorMode.store(mode); }
+    DetectorMode getDetectorMode() const { return detectorMode.load(); }
 
-    float getGainReductionMeter() const { return meterGainReduction.load(); }
-    float getInputLevelMeter() const { return meterInputLevel.load(); }
-    float getDetectionLevelMeter() const { return meterDetectionLevel.load(); }
+    // Runs only the (linked) detector over a mono signal and writes the per-sample gain
+    // that processBlock would apply to the delayed audio. For offline analysis;
+    // don't interleave with processBlock on the same instance.
+    void analyseGainCurve(const float* monoInput, float* gainOut, int numSamples);
+
+    // Offline two-pass rendering, after prepareToPlay. beginLevelAnalysis sets
+    // the profile up for this instance's detection units, filter and cutoff,
+    // then analyseLevels feeds it the whole input block by block. With a finished
+    // profile set, processBlock takes every unit's auto-threshold reference
+    // from it while isNonRealtime(); pass nullptr to go back to the follower.
+    // The profile must outlive its use and positions count from prepareToPlay.
+    void beginLevelAnalysis(LoudnessProfile& profile, juce::int64 expectedLength = 0);
+    void analyseLevels(const juce::AudioBuffer<float>& buffer, int numSamples, LoudnessProfile& profile);
+    void setLevelProfile(const LoudnessProfile* profile) { levelProfile = profile; }
+
+    // Offline gain-envelope cache, off by default. While on, offline renders
+    // without the spectral gate or a level profile store their detection
+    // results, and a later render of the same input from prepareToPlay on
+    // replays them instead of detecting again (see GainEnvelopeCache).
+    // Touch the cache itself only while not processing.
+    void setGainCacheEnabled(bool shouldCache) { gainCacheEnabled.store(shouldCache); }
+    GainEnvelopeCache& getGainCache() { return gainCache; }
 
 private:
+    // Fills in the parameter pointers above
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    // Every parameter in layout order, for state and snapshots. Values are
+    // plain (a choice's index, a bool's 0/1).
+    static constexpr int MAX_STATE_PARAMETERS = 16;
+    std::vector<juce::RangedAudioParameter*> stateParameters;
+    void captureParameters(float* values) const;
+    void applyParameters(const float* values);
+
+    bool readBinaryState(const void* data, int sizeInBytes);
+    void readLegacyState(const void* data, int sizeInBytes);
+
+    struct Snapshot
+    {
+        bool isValid = false;
+        float values[MAX_STATE_PARAMETERS] = {};
+    };
+
+    Snapshot snapshots[NUM_SNAPSHOTS];
+    int activeSnapshot = 0;
+
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    // Look-ahead delay buffer
-    static constexpr int MAX_LOOKAHEAD_SAMPLES = 512; // ~11ms at 44.1kHz
-    std::vector<std::vector<float>> delayBuffer;
-    int delayWritePos = 0;
+    // Look-ahead delay, sized for MAX_LOOKAHEAD_MS at the current sample rate.
+    // Only the one for the prepared precision is allocated.
+    LookaheadDelayLine delayLine;
+    BasicLookaheadDelayLine<double> delayLineDouble;
     int lookaheadSamples = 0;
+    int maxLookaheadSamples = 0;
+
+    int lookaheadMsToSamples(float ms) const;
 
-    // Plosive detection filter (isolates low frequencies)
-    struct BiquadFilter {
-        float b0 = 0, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
-        float z1 = 0, z2 = 0;
+    // Plosive detection: low-pass, envelopes and gain smoothing for every
+    // detection unit
+    PlosiveDetector detector;
 
-        float process(float input) {
-            float output = b0 * input + b1 * z1 + b2 * z2 - a1 * z1 - a2 * z2;
-            z2 = z1;
-            z1 = output;
-            return output;
-        }
+    // Which detection unit drives each channel, for one link mode. Built in
+    // prepareToPlay from the bus layout so processBlock only indexes tables.
+    struct ChannelGrouping
+    {
+        int numUnits = 1;
+        int unitOfChannel[MAX_CHANNELS] = {};
 
-        void reset() { z1 = z2 = 0; }
+        // Mid/side only: the other channel of each channel's pair, or -1. The
+        // first channel of a pair carries mid, the second side.
+        int partnerOfChannel[MAX_CHANNELS] = {};
     };
 
-    BiquadFilter detectionLPF;  // Low-pass for detecting plosives
-    BiquadFilter duckingHPF;    // High-pass for ducking low frequencies
+    // Spectral gate; its window follows the look-ahead
+    SpectralDetector spectralDetector;
+    bool spectralWasActive = false;
+
+    // Spectral repair: an STFT on the delayed path. Its own delay stands in
+    // for as much of the look-ahead as it covers.
+    SpectralRepair spectralRepair;
+    bool repairWasActive = false;
+
+    PlosiveDetector::Filter getDetectionFilter() const;
+    int getRepairOrder() const;
+    int getAudioDelay(bool useRepair) const;
+    void updateLatency(bool useRepair);
+
+    // processBlock only records the latency it needs; the timer passes it on
+    // to the host off the audio thread
+    std::atomic<int> pendingLatency{0};
+    void timerCallback() override;
+
+    // Offline auto-threshold references, see setLevelProfile
+    const LoudnessProfile* levelProfile = nullptr;
+
+    // Offline gain-envelope cache. The key chain starts at prepareToPlay and
+    // breaks for good at the first block that can't use the cache.
+    GainEnvelopeCache gainCache;
+    std::atomic<bool> gainCacheEnabled{false};
+    GainEnvelopeCache::Key gainCacheKey = GainEnvelopeCache::CHAIN_START;
+    bool gainCacheChainValid = false;
+
+    void detectWithCache(int numSamples, float thresholdDb, float reductionAmount, float cutoffHz);
+
+    // Event log: detection state per unit -> eventQueue
+    PlosiveEventTracker eventTracker;
+    juce::int64 samplePosition = 0;
+
+    ChannelGrouping groupings[numLinkModes];
+    int activeLinkMode = linked;
+
+    void buildChannelGroupings(const juce::AudioChannelSet& layout, int numChannels);
+
+    // Split-band mode: LR4 crossover at `frequency`, gain applied to the low band only
+    LinkwitzRileyCrossover crossover;
+    BasicLinkwitzRileyCrossover<double> crossoverDouble;
+
+    // Double precision: set from isUsingDoublePrecision() in prepareToPlay.
+    // Blocks of the other precision pass through unprocessed. The float
+    // buffer holds detection input and spectral repair audio for one chunk.
+    bool preparedForDouble = false;
+    juce::AudioBuffer<float> conversionBuffer;
+
+    // Automation: sensitivity, reduction and the cutoff glide to new values,
+    // stepped every PARAMETER_UPDATE_INTERVAL samples of the stream. While
+    // the cutoff moves, coefficients come from a trig table.
+    static constexpr int PARAMETER_UPDATE_INTERVAL = 32;
+    juce::SmoothedValue<float> smoothedThreshold;
+    juce::SmoothedValue<float> smoothedReduction;  // 0-1
+    juce::SmoothedValue<float> smoothedFrequency;
+    BiquadTrigTable trigTable;
+
+    // The ramps' values for the cell that ends at rampCellEnd (a stream position)
+    juce::int64 rampCellEnd = 0;
+    float rampThreshold = 0.0f, rampReduction = 0.0f, rampFrequency = 0.0f;
+    bool rampFrequencyMoving = false;
+
+    bool isSmoothingParameters() const;
+
+    std::atomic<DetectorMode> detectorMode{DetectorMode::logDomain};
+
+    // Longest chunk the detector scratch holds (the prepared block size).
+    // Host blocks longer than this are processed in several chunks.
+    int maxChunkSize = 0;
+
+    // Channels prepareToPlay allocated for, and the ones the current block processes
+    int numPreparedChannels = 0;
+    int numActiveChannels = 0;
+
+    // The block pipeline, for float or double buffers
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
 
-    // Per-channel ducking filters (2 cascaded for 24dB/octave slope)
-    std::vector<BiquadFilter> channelHPF1;
-    std::vector<BiquadFilter> channelHPF2;
+    // Pipeline stages, run in order over each chunk
+    void mixDetectionInput(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
 
-    // Envelope followers
-    float fastEnvelope = 0.0f;   // Fast attack for transient detection
-    float slowEnvelope = 0.0f;   // Slow for sustained content
-    float fastAttack = 0.0f;
-    float fastRelease = 0.0f;
-    float slowAttack = 0.0f;
-    float slowRelease = 0.0f;
+    template <typename SampleType>
+    void applyGain(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples, bool useSplitBand, bool useRepair);
 
-    // Auto-threshold: track average signal level
-    float avgLevel = 0.0f;
-    float avgLevelCoeff = 0.0f;
+    // Codes every pair of the mid/side grouping in place, L/R to M/S or back.
+    // skipIdlePairs leaves pairs alone whose mid and side gains are both exactly 1.
+    template <typename SampleType>
+    void convertMidSide(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples,
+                        bool toMidSide, bool skipIdlePairs);
 
-    // Gain reduction (smoothed)
-    float currentGainReduction = 1.0f;
-    float targetGainReduction = 1.0f;
-    float gainSmoothCoeff = 0.0f;
+    void copyToConversionBuffer(const juce::AudioBuffer<double>& buffer, int startSample, int numSamples);
+    void copyFromConversionBuffer(juce::AudioBuffer<double>& buffer, int startSample, int numSamples) const;
 
     // Helper functions
-    void updateDetectionFilter(float cutoffHz);
-    void updateDuckingFilter(float cutoffHz, float gainReduction);
-    void calculateBiquadLPF(BiquadFilter& filter, float cutoffHz, float q = 0.707f);
-    void calculateBiquadHPF(BiquadFilter& filter, float cutoffHz, float q = 0.707f);
+    void updateFilters(float cutoffHz, bool ramping);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlosiveRemoverProcessor)
 };
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <vector>
+
+// Single-producer/single-consumer queue for handing data from the audio
+// thread to another thread. Storage is allocated once in the constructor;
+// push never locks or allocates. (AbstractFifo keeps one slot free, so it
+// holds Capacity - 1 items.)
+template <typename Item, int Capacity>
+class RealtimeFifo
+{
+public:
+    RealtimeFifo() : fifo(Capacity), items(Capacity) {}
+
+    // Producer. If the reader has fallen behind the item is dropped and counted.
+    bool push(const Item& item)
+    {
+        auto scope = fifo.write(1);
+
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        scope.forEach([&](int index) { items[static_cast<size_t>(index)] = item; });
+        return true;
+    }
+
+    // Consumer. Calls fn for every item pushed since the last drain, in order.
+    template <typename Callback>
+    int drain(Callback&& fn)
+    {
+        auto numReady = fifo.getNumReady();
+        auto scope = fifo.read(numReady);
+        scope.forEach([&](int index) { fn(items[static_cast<size_t>(index)]); });
+        return numReady;
+    }
+
+    // Items lost because the FIFO was full, since the last call
+    int takeDroppedCount() { return dropped.exchange(0, std::memory_order_relaxed); }
+
+private:
+    juce::AbstractFifo fifo;
+    std::vector<Item> items;
+    std::atomic<int> dropped{0};
+};
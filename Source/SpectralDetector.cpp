@@ -0,0 +1,194 @@
+#include "SpectralDetector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Gate thresholds. An onset is a hop where the low-band flux exceeds
+    // ONSET_FLUX times the recent low-band peak (a peak hold that falls
+    // 6 dB in PEAK_HOLD_SECONDS). Comparing against the peak rather than the
+    // previous hop matters because a window shorter than a bass note's period
+    // sees its low band swing from hop to hop. The gate opens on an onset
+    // frame with at least OPEN_RATIO of its energy in the low band, so
+    // broadband attacks don't open it. It then stays open while the ratio is
+    // above HOLD_RATIO, for at most MAX_OPEN_SECONDS (longer than any plosive),
+    // so a sustained bass note can hold it only briefly after its attack.
+    // Frames quieter than SILENCE_LEVEL (-50 dBFS mean square) always close it.
+    constexpr float ONSET_FLUX = 1.0f;
+    constexpr double PEAK_HOLD_SECONDS = 0.03;
+    constexpr float OPEN_RATIO = 0.8f;
+    constexpr float HOLD_RATIO = 0.6f;
+    constexpr double MAX_OPEN_SECONDS = 0.15;
+    constexpr float SILENCE_LEVEL = 1.0e-5f;
+
+    constexpr int MAX_BINS = SpectralDetector::MAX_WINDOW / 2 + 1;
+}
+
+void SpectralDetector::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    if (ffts.empty())
+        for (int o = MIN_ORDER; o <= MAX_ORDER; ++o)
+            ffts.push_back(std::make_unique<juce::dsp::FFT>(o));
+
+    window.assign(MAX_WINDOW, 0.0f);
+    fftBuffer.assign(2 * MAX_WINDOW, 0.0f);
+    power.assign(MAX_BINS, 0.0f);
+    rings.assign(static_cast<size_t>(PlosiveDetector::MAX_UNITS * MAX_WINDOW), 0.0f);
+    previousMagnitudes.assign(static_cast<size_t>(PlosiveDetector::MAX_UNITS * MAX_BINS), 0.0f);
+
+    order = 0; // force setWindowForLookahead to rebuild the window
+    setWindowForLookahead(MAX_WINDOW);
+}
+
+void SpectralDetector::release()
+{
+    ffts.clear();
+    window.clear();
+    fftBuffer.clear();
+    power.clear();
+    rings.clear();
+    previousMagnitudes.clear();
+    order = 0;
+}
+
+void SpectralDetector::reset()
+{
+    std::fill(rings.begin(), rings.end(), 0.0f);
+    std::fill(previousMagnitudes.begin(), previousMagnitudes.end(), 0.0f);
+
+    for (auto& state : units)
+        state = UnitState{};
+}
+
+void SpectralDetector::setWindowForLookahead(int lookaheadSamples)
+{
+    int newOrder = MIN_ORDER;
+    while (newOrder < MAX_ORDER && (2 << newOrder) <= lookaheadSamples)
+        ++newOrder;
+
+    if (newOrder == order)
+        return;
+
+    order = newOrder;
+    windowSize = 1 << order;
+    hopSize = windowSize / 2;
+
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), static_cast<size_t>(windowSize),
+                                                             juce::dsp::WindowingFunction<float>::hann, false);
+
+    maxOpenHops = static_cast<int>(MAX_OPEN_SECONDS * sampleRate / hopSize);
+    peakDecay = static_cast<float>(std::pow(0.5, hopSize / (PEAK_HOLD_SECONDS * sampleRate)));
+
+    windowEnergy = 0.0f;
+    for (int i = 0; i < windowSize; ++i)
+        windowEnergy += window[static_cast<size_t>(i)] * window[static_cast<size_t>(i)];
+
+    setLowBandCutoff(lowBandCutoff);
+    reset();
+}
+
+void SpectralDetector::setLowBandCutoff(float cutoffHz)
+{
+    lowBandCutoff = cutoffHz;
+
+    auto binHz = static_cast<float>(sampleRate) / static_cast<float>(windowSize);
+    auto bins = static_cast<int>(std::ceil(cutoffHz / binHz)) + 1;
+    numLowBins = juce::jlimit(1, windowSize / 2, bins);
+}
+
+void SpectralDetector::process(const float* input, float* gateOut, int numUnits, int numSamples)
+{
+    const int mask = windowSize - 1;
+
+    for (int unit = 0; unit < numUnits; ++unit)
+    {
+        auto& state = units[unit];
+        auto* ring = rings.data() + static_cast<size_t>(unit * MAX_WINDOW);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            ring[state.writePos] = input[i * numUnits + unit];
+            state.writePos = (state.writePos + 1) & mask;
+
+            gateOut[i * numUnits + unit] = state.gate;
+            state.gate = juce::jlimit(0.0f, 1.0f, state.gate + state.gateStep);
+
+            if (++state.hopCounter == hopSize)
+            {
+                state.hopCounter = 0;
+                analyse(unit);
+            }
+        }
+    }
+}
+
+void SpectralDetector::analyse(int unit)
+{
+    auto& state = units[unit];
+    const auto* ring = rings.data() + static_cast<size_t>(unit * MAX_WINDOW);
+    auto* frame = fftBuffer.data();
+
+    // Unroll the ring, oldest sample first, and window it
+    auto first = windowSize - state.writePos;
+    juce::FloatVectorOperations::copy(frame, ring + state.writePos, first);
+    juce::FloatVectorOperations::copy(frame + first, ring, state.writePos);
+    juce::FloatVectorOperations::multiply(frame, window.data(), windowSize);
+
+    float energy = 0.0f;
+    for (int i = 0; i < windowSize; ++i)
+        energy += frame[i] * frame[i];
+
+    juce::FloatVectorOperations::clear(frame + windowSize, windowSize);
+    ffts[static_cast<size_t>(order - MIN_ORDER)]->performRealOnlyForwardTransform(frame, true);
+
+    // Power per bin from the interleaved re/im output
+    const int numBins = windowSize / 2 + 1;
+    auto* binPower = power.data();
+    float totalPower = 0.0f;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        float re = frame[2 * k];
+        float im = frame[2 * k + 1];
+        binPower[k] = re * re + im * im;
+        totalPower += binPower[k];
+    }
+
+    // Low-band ratio and positive low-band flux (magnitudes, so the flux
+    // isn't dominated by the loudest bin)
+    auto* previous = previousMagnitudes.data() + static_cast<size_t>(unit * MAX_BINS);
+    float lowPower = 0.0f, lowMagnitude = 0.0f, flux = 0.0f;
+
+    for (int k = 0; k < numLowBins; ++k)
+    {
+        float magnitude = std::sqrt(binPower[k]);
+        flux += std::max(0.0f, magnitude - previous[k]);
+        lowMagnitude += magnitude;
+        lowPower += binPower[k];
+        previous[k] = magnitude;
+    }
+
+    bool quiet = energy < SILENCE_LEVEL * windowEnergy;
+    float ratio = totalPower > 0.0f ? lowPower / totalPower : 0.0f;
+    bool onset = state.primed && !quiet && flux > ONSET_FLUX * state.recentPeak;
+
+    state.recentPeak = std::max(lowMagnitude, state.recentPeak * peakDecay);
+
+    if (quiet)
+        state.open = false;
+    else if (state.open)
+        state.open = ratio > HOLD_RATIO && ++state.openHops < maxOpenHops;
+    else if (onset)
+        state.open = ratio > OPEN_RATIO;
+
+    if (!state.open)
+        state.openHops = 0;
+
+    state.primed = true;
+
+    // Ramp to the new state over the next hop
+    float target = state.open ? 1.0f : 0.0f;
+    state.gateStep = (target - state.gate) / static_cast<float>(hopSize);
+}
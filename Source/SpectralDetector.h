@@ -0,0 +1,92 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "PlosiveDetector.h"
+#include <memory>
+#include <vector>
+
+// Optional FFT-based gate in front of PlosiveDetector. The envelope
+// detector alone reacts to any low-frequency burst, so kick drum bleed and
+// proximity-effect bass trigger it too. This looks at the spectrum of each
+// detection unit's input over short overlapping Hann windows and only lets
+// the detector reduce while the frame looks like a plosive:
+//
+//  - low-band energy ratio: energy below the detection cutoff / total
+//    energy. Plosives are almost entirely low band; a kick's beater click
+//    and most speech are not.
+//  - spectral flux: the increase in low-band magnitude since the previous
+//    hop, relative to the recent low-band peak. This is high at a plosive's
+//    onset and stays low for sustained bass.
+//
+// The gate opens at an onset (high flux) whose first frame is low-band
+// dominated. It stays open while the ratio stays high, up to a maximum hold,
+// and ramps linearly between states over one hop.
+//
+// The window is the largest power of two (64-2048 samples) that fits in the
+// look-ahead, so the extra detection delay stays inside the latency the
+// plugin already reports. Hops are half a window (50% overlap).
+//
+// CPU cost per unit and hop of N/2 samples: copying and windowing N samples,
+// one N-point real FFT, and N/2+1 power bins (a vectorizable
+// multiply-add). That is O(N log N) per hop, or about 2*log2(N) + 6
+// operations per input sample per unit, whatever the block size.
+// PlosiveBenchmark --spectral measures it.
+class SpectralDetector
+{
+public:
+    static constexpr int MIN_ORDER = 6;   // 64 samples
+    static constexpr int MAX_ORDER = 11;  // 2048 samples
+    static constexpr int MAX_WINDOW = 1 << MAX_ORDER;
+
+    // Allocates the FFTs for every window size and all unit state
+    void prepare(double sampleRate);
+    void release();
+    void reset();
+
+    // Picks the largest window that fits in the look-ahead and resets the
+    // analysis. Doesn't allocate.
+    void setWindowForLookahead(int lookaheadSamples);
+    int getWindowSize() const { return windowSize; }
+
+    // Bins at or below this frequency (plus one for window leakage) count as low band
+    void setLowBandCutoff(float cutoffHz);
+
+    // Reads numSamples of interleaved detection input (numUnits lanes, as in
+    // PlosiveDetector::getInputBuffer) and writes the per-sample gate, 0-1,
+    // in the same layout
+    void process(const float* input, float* gateOut, int numUnits, int numSamples);
+
+private:
+    void analyse(int unit);
+
+    struct UnitState
+    {
+        int writePos = 0;
+        int hopCounter = 0;
+        bool primed = false;   // false until a first frame gives the flux a reference
+        bool open = false;
+        int openHops = 0;
+        float recentPeak = 0.0f;  // low-band magnitude, peak hold
+        float gate = 0.0f;
+        float gateStep = 0.0f;
+    };
+
+    double sampleRate = 44100.0;
+    int order = 0;
+    int windowSize = 1 << MIN_ORDER;
+    int hopSize = (1 << MIN_ORDER) / 2;
+    int numLowBins = 1;
+    int maxOpenHops = 1;
+    float peakDecay = 0.0f;
+    float lowBandCutoff = 300.0f;
+    float windowEnergy = 1.0f;     // sum of squared window samples
+
+    std::vector<std::unique_ptr<juce::dsp::FFT>> ffts;  // index: order - MIN_ORDER
+    std::vector<float> window;
+    std::vector<float> fftBuffer;      // 2 * MAX_WINDOW, as the real-only transform needs
+    std::vector<float> power;          // per bin, from the last transform
+    std::vector<float> rings;          // per unit: the last windowSize input samples
+    std::vector<float> previousMagnitudes; // per unit: low-band magnitudes of the last hop
+
+    UnitState units[PlosiveDetector::MAX_UNITS];
+};
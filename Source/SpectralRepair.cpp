@@ -0,0 +1,152 @@
+#include "SpectralRepair.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Hops whose lowest gain is above this (-0.01 dB) count as untouched and
+    // take the pass-through path. The detector's release only approaches 1.
+    constexpr float UNITY_GAIN = 0.999f;
+}
+
+void SpectralRepair::prepare(double newSampleRate, int numChannels)
+{
+    sampleRate = newSampleRate;
+    numPreparedChannels = numChannels;
+
+    if (ffts.empty())
+        for (int o = MIN_ORDER; o <= MAX_ORDER; ++o)
+            ffts.push_back(std::make_unique<juce::dsp::FFT>(o));
+
+    window.assign(MAX_FFT_SIZE, 0.0f);
+    fftBuffer.assign(2 * MAX_FFT_SIZE, 0.0f);
+    inputRings.assign(static_cast<size_t>(numChannels * MAX_FFT_SIZE), 0.0f);
+    outputRings.assign(static_cast<size_t>(numChannels * MAX_FFT_SIZE), 0.0f);
+    hopMinGain.assign(static_cast<size_t>(numChannels), 1.0f);
+
+    auto requestedOrder = order > 0 ? order : MIN_ORDER;
+    order = 0; // force setOrder to rebuild the window
+    setOrder(requestedOrder);
+}
+
+void SpectralRepair::release()
+{
+    ffts.clear();
+    window.clear();
+    fftBuffer.clear();
+    inputRings.clear();
+    outputRings.clear();
+    hopMinGain.clear();
+    numPreparedChannels = 0;
+}
+
+void SpectralRepair::reset()
+{
+    std::fill(inputRings.begin(), inputRings.end(), 0.0f);
+    std::fill(outputRings.begin(), outputRings.end(), 0.0f);
+    std::fill(hopMinGain.begin(), hopMinGain.end(), 1.0f);
+    position = 0;
+    hopCounter = 0;
+}
+
+void SpectralRepair::setOrder(int newOrder)
+{
+    newOrder = juce::jlimit(MIN_ORDER, MAX_ORDER, newOrder);
+
+    if (newOrder == order)
+        return;
+
+    order = newOrder;
+    fftSize = 1 << order;
+    hopSize = fftSize / 2;
+
+    // Periodic Hann, square-rooted: applied on analysis and synthesis, the
+    // squared windows of frames half a window apart add up to one
+    if (!window.empty())
+        for (int i = 0; i < fftSize; ++i)
+            window[static_cast<size_t>(i)] = std::sqrt(0.5f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi
+                                                                              * static_cast<float>(i) / static_cast<float>(fftSize)));
+
+    reset();
+}
+
+void SpectralRepair::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                             int numChannels, const float* const* channelGains)
+{
+    numChannels = std::min(numChannels, numPreparedChannels);
+
+    for (int done = 0; done < numSamples;)
+    {
+        // Hops divide the ring, so a segment never wraps
+        auto segment = std::min(numSamples - done, hopSize - hopCounter);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* io = buffer.getWritePointer(channel, startSample + done);
+            auto* input = inputRings.data() + static_cast<size_t>(channel * MAX_FFT_SIZE) + position;
+            auto* output = outputRings.data() + static_cast<size_t>(channel * MAX_FFT_SIZE) + position;
+
+            auto& minGain = hopMinGain[static_cast<size_t>(channel)];
+            minGain = std::min(minGain, juce::FloatVectorOperations::findMinimum(channelGains[channel] + done, segment));
+
+            juce::FloatVectorOperations::copy(input, io, segment);
+            juce::FloatVectorOperations::copy(io, output, segment);
+            juce::FloatVectorOperations::clear(output, segment);
+        }
+
+        position = (position + segment) & (fftSize - 1);
+        hopCounter += segment;
+        done += segment;
+
+        if (hopCounter == hopSize)
+        {
+            hopCounter = 0;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                processFrame(channel, hopMinGain[static_cast<size_t>(channel)]);
+                hopMinGain[static_cast<size_t>(channel)] = 1.0f;
+            }
+        }
+    }
+}
+
+void SpectralRepair::processFrame(int channel, float gain)
+{
+    const auto* input = inputRings.data() + static_cast<size_t>(channel * MAX_FFT_SIZE);
+    auto* output = outputRings.data() + static_cast<size_t>(channel * MAX_FFT_SIZE);
+    auto* frame = fftBuffer.data();
+
+    // Unroll the ring, oldest sample first; that sample is the next one out
+    auto first = fftSize - position;
+    juce::FloatVectorOperations::copy(frame, input + position, first);
+    juce::FloatVectorOperations::copy(frame + first, input, position);
+    juce::FloatVectorOperations::multiply(frame, window.data(), fftSize);
+
+    if (gain < UNITY_GAIN)
+    {
+        juce::FloatVectorOperations::clear(frame + fftSize, fftSize);
+
+        auto& fft = *ffts[static_cast<size_t>(order - MIN_ORDER)];
+        fft.performRealOnlyForwardTransform(frame, true);
+
+        // Full reduction up to the cutoff bin, fading out over the next bin
+        auto cutoffBin = cutoff * static_cast<float>(fftSize) / static_cast<float>(sampleRate);
+        auto lastBin = std::min(fftSize / 2, static_cast<int>(cutoffBin) + 1);
+
+        for (int k = 0; k <= lastBin; ++k)
+        {
+            auto amount = juce::jlimit(0.0f, 1.0f, cutoffBin + 1.0f - static_cast<float>(k));
+            auto binGain = 1.0f - amount * (1.0f - gain);
+            frame[2 * k] *= binGain;
+            frame[2 * k + 1] *= binGain;
+        }
+
+        fft.performRealOnlyInverseTransform(frame);
+    }
+
+    juce::FloatVectorOperations::multiply(frame, window.data(), fftSize);
+
+    juce::FloatVectorOperations::add(output + position, frame, first);
+    juce::FloatVectorOperations::add(output, frame + first, position);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <vector>
+
+// Overlap-add STFT that applies the detector's gain only to the bins below
+// a cutoff, so a pop is taken out of the low end without dipping the rest
+// of the voice.
+//
+// Periodic sqrt-Hann analysis and synthesis windows at 50% overlap sum to
+// unity, so frames whose gain is 1 reconstruct the input (to rounding). Those
+// frames skip the FFT altogether; only frames that need repair pay for a
+// forward and an inverse transform.
+//
+// The engine delays audio by exactly its FFT size. Each hop uses the lowest
+// detector gain seen during that hop, for each channel. Memory is allocated
+// in prepare for the largest size, so switching sizes never allocates.
+//
+// CPU cost per channel and hop of N/2 samples: windowing and overlap-add of
+// N samples, plus one forward and one inverse N-point real FFT when the hop
+// is being repaired.
+class SpectralRepair
+{
+public:
+    static constexpr int MIN_ORDER = 8;   // 256
+    static constexpr int MAX_ORDER = 11;  // 2048
+    static constexpr int MAX_FFT_SIZE = 1 << MAX_ORDER;
+
+    // Allocates for numChannels at the largest FFT size; call from prepareToPlay
+    void prepare(double sampleRate, int numChannels);
+    void release();
+    void reset();
+
+    // Selects the FFT size (2^order) and clears the overlap-add state if it changed.
+    // Doesn't allocate.
+    void setOrder(int newOrder);
+    int getFftSize() const { return fftSize; }
+    int getLatencySamples() const { return fftSize; }
+
+    void setCutoff(float cutoffHz) { cutoff = cutoffHz; }
+
+    // Processes numChannels channels in place. channelGains[ch][i] is the
+    // detector gain for sample i, as passed to the broadband path.
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                 int numChannels, const float* const* channelGains);
+
+private:
+    void processFrame(int channel, float gain);
+
+    double sampleRate = 44100.0;
+    int numPreparedChannels = 0;
+    int order = 0;
+    int fftSize = 1 << MIN_ORDER;
+    int hopSize = (1 << MIN_ORDER) / 2;
+    float cutoff = 200.0f;
+
+    int position = 0;     // shared ring position (input write = output read)
+    int hopCounter = 0;
+
+    std::vector<std::unique_ptr<juce::dsp::FFT>> ffts;  // index: order - MIN_ORDER
+    std::vector<float> window;          // periodic sqrt-Hann
+    std::vector<float> fftBuffer;       // 2 * MAX_FFT_SIZE
+    std::vector<float> inputRings;      // per channel, MAX_FFT_SIZE
+    std::vector<float> outputRings;     // per channel overlap-add accumulators, MAX_FFT_SIZE
+    std::vector<float> hopMinGain;      // per channel
+};